@@ -0,0 +1,132 @@
+/**
+ * @file kernel_stats.hpp
+ * @brief Counters and timers of the arithmetic kernels, which are always compiled in.
+ */
+#ifndef INCLUDE_COMMON_KERNEL_STATS_HPP_
+#define INCLUDE_COMMON_KERNEL_STATS_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+enum KernelOperation: uint8_t {
+    POWER_SERIES_MULTIPLY,
+    POWER_SERIES_INVERT,
+    POWER_SERIES_EXP,
+    POWER_SERIES_LOG,
+    POWER_SERIES_COMPOSE,
+    POLYNOMIAL_MULTIPLY,
+    POLYNOMIAL_DIVIDE,
+    POLYNOMIAL_GCD,
+    RATIONAL_NORMALIZE,
+    NUM_KERNEL_OPERATIONS
+};
+
+enum KernelAlgorithm: uint8_t {
+    SCHOOLBOOK,
+    SPARSE,
+    KARATSUBA,
+    NEWTON,
+    NAIVE,
+    EUCLIDEAN,
+    HALF_GCD,
+    MODULAR_GCD,
+    NATIVE_INTEGERS,  // operands fitting into 64 bits
+    GMP_INTEGERS,
+    NUM_KERNEL_ALGORITHMS
+};
+
+#define KERNEL_SIZE_BUCKETS 24  // bucket i > 0 holds sizes in [2^(i-1), 2^i), the last one also all larger sizes
+#define KERNEL_TIME_BUCKETS 8  // bucket i > 0 holds times in [10^(i-1), 10^i) microseconds, the last one also all longer times
+
+/**
+ * @brief The statistics of one kernel operation.
+ *
+ * The counters are atomic only to make concurrent updates well defined; increments are plain loads and stores, so
+ * kernels running in several threads at once may lose counts.
+ */
+struct KernelCounters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> timed_calls;
+    std::atomic<uint64_t> nanoseconds;
+    std::atomic<uint64_t> total_size;
+    std::atomic<uint64_t> max_size;
+    std::atomic<uint64_t> algorithms[NUM_KERNEL_ALGORITHMS];
+    std::atomic<uint64_t> sizes[KERNEL_SIZE_BUCKETS];
+    std::atomic<uint64_t> times[KERNEL_TIME_BUCKETS];
+};
+
+inline KernelCounters kernel_counters[NUM_KERNEL_OPERATIONS];
+inline thread_local uint32_t kernel_depths[NUM_KERNEL_OPERATIONS];  // the number of active calls of each operation
+
+inline void add_to_kernel_counter(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed)+value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts a kernel call without timing it, for kernels too cheap to read the clock twice.
+ *
+ * @param size The size of the operands, e.g. the number of coefficients.
+ */
+inline void count_kernel_call(KernelOperation operation, uint64_t size, KernelAlgorithm algorithm) {
+    auto& counters = kernel_counters[operation];
+    add_to_kernel_counter(counters.calls, 1);
+    add_to_kernel_counter(counters.total_size, size);
+    if (size > counters.max_size.load(std::memory_order_relaxed)) {
+        counters.max_size.store(size, std::memory_order_relaxed);
+    }
+    add_to_kernel_counter(counters.algorithms[algorithm], 1);
+    uint32_t bucket = size == 0 ? 0 : 64-__builtin_clzll(size);
+    add_to_kernel_counter(counters.sizes[bucket < KERNEL_SIZE_BUCKETS ? bucket : KERNEL_SIZE_BUCKETS-1], 1);
+}
+
+/**
+ * @class KernelTimer
+ * @brief Counts and times a kernel call for its lifetime.
+ *
+ * Nested calls of the same operation, like the recursion of Karatsuba multiplication, are part of the outermost
+ * call and not counted.
+ */
+class KernelTimer {
+    KernelOperation operation;
+    bool outermost;
+    std::chrono::steady_clock::time_point start;
+
+ public:
+    KernelTimer(KernelOperation operation, uint64_t size, KernelAlgorithm algorithm) :
+        operation(operation), outermost(kernel_depths[operation]++ == 0) {
+        if (outermost) {
+            count_kernel_call(operation, size, algorithm);
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~KernelTimer() {
+        kernel_depths[operation]--;
+        if (!outermost) {
+            return;
+        }
+        uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count();
+        auto& counters = kernel_counters[operation];
+        add_to_kernel_counter(counters.timed_calls, 1);
+        add_to_kernel_counter(counters.nanoseconds, elapsed);
+        uint32_t bucket = 0;
+        for (uint64_t limit = 1000; elapsed >= limit && bucket < KERNEL_TIME_BUCKETS-1; limit *= 10) {
+            bucket++;
+        }
+        add_to_kernel_counter(counters.times[bucket], 1);
+    }
+
+    KernelTimer(const KernelTimer&) = delete;
+    KernelTimer& operator=(const KernelTimer&) = delete;
+};
+
+/**
+ * @brief Writes the statistics of all kernels called since the last reset.
+ */
+void write_kernel_statistics(std::ostream& stream);
+
+void reset_kernel_statistics();
+
+#endif  // INCLUDE_COMMON_KERNEL_STATS_HPP_
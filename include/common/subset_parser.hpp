@@ -7,9 +7,11 @@
  * @author vabi
  */
 #pragma once
+#include <stdint.h>
 #include <string>
 #include <set>
 #include <algorithm>
+#include <stdexcept>
 #include "string_utils/string_utils.hpp"
 
 class SubsetArgumentException : public std::exception {
@@ -25,12 +27,27 @@ class SubsetArgumentException : public std::exception {
     }
 };
 
+#define SUBSET_RANGE_UNBOUNDED UINT32_MAX
+
 struct Subset {
     // TODO(vabi) this is a quick and dirty implementation
     uint32_t exclusive_max;
     std::set<uint32_t> indices;
     bool negate;
 
+    // contiguous range [range_min, range_max]; filled in for "=n", ">n", ">=n", "<n", "<=n" and the complete subset
+    bool is_range;
+    uint32_t range_min;
+    uint32_t range_max;  // inclusive, SUBSET_RANGE_UNBOUNDED for cofinite ranges
+
+    /**
+     * @brief Checks whether the subset is a cofinite range, i.e. contains all integers from range_min on.
+     * @return True if the subset is a cofinite range.
+     */
+    bool is_cofinite() const {
+        return is_range && range_max == SUBSET_RANGE_UNBOUNDED;
+    }
+
     static int parse_integer_from_str(const std::string& to_parse, const std::string& full_arg) {
         int num;
         try {
@@ -43,13 +60,16 @@ struct Subset {
         return num;
     }
 
-    Subset(const std::string& arg, const uint32_t exclusive_max): exclusive_max(exclusive_max) {
+    Subset(const std::string& arg, const uint32_t exclusive_max): exclusive_max(exclusive_max), is_range(false), range_min(0), range_max(SUBSET_RANGE_UNBOUNDED) {
         if (arg.rfind("=", 1) == 0) {
             int num;
             num = parse_integer_from_str(arg.substr(1), arg);
             negate = false;
             if (num >= 0) {
                 indices.insert(num);
+                is_range = true;
+                range_min = num;
+                range_max = num;
             }
         } else if (arg.rfind(">", 1) == 0) {
             int32_t num;
@@ -60,6 +80,8 @@ struct Subset {
             }
 
             num = std::max(0, num);
+            is_range = true;
+            range_min = num;
             uint32_t sanitized_num = std::min((uint32_t) num, exclusive_max);
             uint32_t num_elements = exclusive_max-sanitized_num;
 
@@ -83,6 +105,8 @@ struct Subset {
                 num = parse_integer_from_str(arg.substr(1), arg)-1;
             }
             num = std::max(0, num);
+            is_range = true;
+            range_max = num;
             uint32_t sanitized_num = std::min((uint32_t) num, exclusive_max);
             uint32_t num_elements = sanitized_num;
             if (num_elements < exclusive_max/2) {
@@ -115,6 +139,7 @@ struct Subset {
                 throw SubsetArgumentException(arg, "Unknown start symbol");
             }
             negate = true;
+            is_range = true;
         }
     }
 };
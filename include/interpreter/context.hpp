@@ -3,7 +3,6 @@
 #include <string>
 #include <map>
 #include <cstdint>
-#include <stack>
 #include <queue>
 #include <vector>
 #include <utility>
@@ -13,11 +12,53 @@
 #include "exceptions/parsing_type_exception.hpp"
 #include "shell/parameters/parameters.hpp"
 #include "common/file_location.hpp"
+#include "interpreter/profiler.hpp"
 #include "modules/module_registration/module_registration.hpp"
 #include "string_utils/string_utils.hpp"
 
 class PolishCustomFunction;
 
+/**
+ * @brief The local variables of a custom function, resolved to slot indices when its body is compiled.
+ */
+class FrameLayout {
+    std::map<std::string, uint32_t> slots;
+
+ public:
+    /**
+     * @brief The slot of a variable, which is added if it has none yet.
+     */
+    uint32_t add_variable(const std::string& name) {
+        return slots.emplace(name, slots.size()).first->second;
+    }
+
+    /**
+     * @brief The slot of a variable, or -1 if it has none.
+     */
+    int64_t find_slot(const std::string& name) const {
+        auto it = slots.find(name);
+        return it != slots.end() ? static_cast<int64_t>(it->second) : -1;
+    }
+
+    uint32_t size() const {
+        return slots.size();
+    }
+
+    const std::map<std::string, uint32_t>& get_slots() const {
+        return slots;
+    }
+};
+
+/**
+ * @brief A variable scope. The variables with a slot in the layout are stored in the shared slot array of the
+ * context, all others by name.
+ */
+struct VariableFrame {
+    std::shared_ptr<const FrameLayout> layout;  // nullptr for scopes without slots, like the global one
+    size_t base;  // index of the first slot of the frame
+    std::map<std::string, std::shared_ptr<SymObject>> named_variables;
+};
+
 class InterpreterPrintHandler {
  public:
     virtual ~InterpreterPrintHandler() = default;
@@ -34,17 +75,22 @@ class InterpreterPrintHandler {
  *
  * @note This class uses virtual destruction to support potential inheritance.
  */
-class InterpreterContext : public ContextInterface, public ModuleContextInterface {
-    std::stack<std::map<std::string, std::shared_ptr<SymObject>>> variables;
+class InterpreterContext : public ContextInterface, public ModuleContextInterface, public std::enable_shared_from_this<InterpreterContext> {
+    std::vector<VariableFrame> frames;
+    std::vector<std::shared_ptr<SymObject>> frame_slots;  // the slots of all frames, contiguously
     std::map<std::string, std::shared_ptr<SymObject>> constants;
     std::shared_ptr<InterpreterPrintHandler> output_handler;
     std::map<std::string, std::shared_ptr<PolishCustomFunction>> custom_functions;
     std::map<std::string, PreprocessedFileNavigator> file_navigators;
     std::vector<std::string> using_namespaces;
     uint64_t steps = 0;
+    const CodePlaceIdentifier* current_position = nullptr;  // the position executed last, for the profiler
+    std::unique_ptr<SamplingProfiler> profiler;  // nullptr if profiling is off
     ShellParameters shell_parameters;
     ModuleRegister modules;
 
+    void record_profiler_sample();
+
  public:
     /**
      * @brief Virtual destructor.
@@ -53,8 +99,17 @@ class InterpreterContext : public ContextInterface, public ModuleContextInterfac
      */
     virtual ~InterpreterContext() = default;
 
-    void push_variables() {
-        variables.push({});
+    /**
+     * @brief Opens a new variable scope, e.g. for a custom function call.
+     *
+     * @param layout The slots of the local variables; nullptr if all variables are stored by name.
+     */
+    void push_variables(const std::shared_ptr<const FrameLayout>& layout = nullptr) {
+        auto base = frame_slots.size();
+        frames.push_back(VariableFrame{layout, base, {}});
+        if (layout) {
+            frame_slots.resize(base+layout->size());
+        }
     }
 
     std::vector<std::string> get_autocompletable_names() const;
@@ -71,12 +126,28 @@ class InterpreterContext : public ContextInterface, public ModuleContextInterfac
 
     void pop_variables();
 
+    /**
+     * @brief The number of variable scopes, i.e. one more than the depth of nested custom function calls.
+     */
+    size_t get_scope_depth() const {
+        return frames.size();
+    }
+
     std::shared_ptr<PolishCustomFunction> get_custom_function(const std::string& name);
 
     void set_custom_function(const std::string& name, std::shared_ptr<PolishCustomFunction> func) {
         custom_functions[name] = func;
     }
 
+    /**
+     * @brief Calls a custom function with already evaluated arguments.
+     *
+     * @param name The name of the custom function.
+     * @param args The argument values.
+     * @return The return value of the function.
+     */
+    std::shared_ptr<SymObject> call_custom_function(const std::string& name, const std::vector<std::shared_ptr<SymObject>>& args) override;
+
     void initialize_constants();
 
     /**
@@ -137,10 +208,80 @@ class InterpreterContext : public ContextInterface, public ModuleContextInterfac
      */
     void set_variable(const std::string& name, std::shared_ptr<SymObject> value);
 
-    inline void increment_steps() {
+    /**
+     * @brief The value of a local variable of the current scope by its slot; nullptr if it is unassigned.
+     */
+    const std::shared_ptr<SymObject>& get_local(uint32_t slot) const {
+        return frame_slots[frames.back().base+slot];
+    }
+
+    /**
+     * @brief Assigns a local variable of the current scope by its slot.
+     */
+    void set_local(uint32_t slot, std::shared_ptr<SymObject> value) {
+        frame_slots[frames.back().base+slot] = std::move(value);
+    }
+
+    /**
+     * @brief Whether name is a builtin constant like true, which cannot be assigned.
+     */
+    bool is_constant(const std::string& name) const {
+        return constants.find(name) != constants.end();
+    }
+
+    /**
+     * @brief Counts a step of the interpreter.
+     *
+     * @param position The position of the executed element, which has to stay alive until the program is done;
+     *                 nullptr for instructions without an element.
+     */
+    inline void increment_steps(const CodePlaceIdentifier* position) {
         steps++;
+        if (position) {
+            current_position = position;
+        }
+        if (profiler_sample_due) {
+            record_profiler_sample();
+        }
+    }
+
+    /**
+     * @brief Forgets the executed position, when the program containing it is done.
+     */
+    void reset_position() {
+        current_position = nullptr;
+    }
+
+    /**
+     * @brief Starts the sampling profiler if the profile_file parameter is set, else discards it.
+     *
+     * @return The profiler, whose samples accumulate over evaluations; nullptr if profiling is off.
+     */
+    SamplingProfiler* start_profiler();
+
+    void stop_profiler() {
+        if (profiler) {
+            profiler->stop();
+        }
+    }
+
+    /**
+     * @brief Puts a call on the stack of the profiler, if it is running.
+     *
+     * @param name The name of the called function, which has to stay alive during the call.
+     * @param has_source Whether the function is a custom function, whose lines are executed as steps.
+     * @return Whether leave_profiled_call has to be called when the call returns.
+     */
+    inline bool enter_profiled_call(const std::string& name, bool has_source) {
+        if (!profiler || !profiler->is_running()) {
+            return false;
+        }
+        profiler->enter(name, current_position, has_source);
+        return true;
     }
 
+    void leave_profiled_call();
+
     uint64_t get_steps() const {
         return steps;
     }
@@ -170,19 +311,11 @@ class InterpreterContext : public ContextInterface, public ModuleContextInterfac
      }
 
      std::shared_ptr<SymObjectContainer> get_module_constant(const std::string& constant_path) const {
-         try {
-             auto parts = string_split(constant_path, '.');
-             if (parts.empty()) {
-                 throw std::runtime_error("Invalid constant path: " + constant_path);
-             }
-             std::queue<std::string> path;
-             for (size_t i = 0; i < parts.size(); ++i) {
-                 path.push(parts[i]);
-             }
-             return modules.get_module_constant(path);
-         } catch (std::runtime_error&) {
+         auto constant = modules.find_module_constant(constant_path);
+         if (constant == nullptr) {
              return nullptr;
          }
+         return constant->get_value();
      }
 
      void add_using_namespaces(const std::vector<std::string>&& namespaces) {
@@ -197,3 +330,24 @@ class InterpreterContext : public ContextInterface, public ModuleContextInterfac
          return using_namespaces;
      }
 };
+
+/**
+ * @brief Keeps a call on the stack of the profiler for its lifetime, also if the call throws.
+ */
+class ProfiledCall {
+    InterpreterContext& context;
+    bool entered;
+
+ public:
+    ProfiledCall(InterpreterContext& context, const std::string& name, bool has_source) :
+        context(context), entered(context.enter_profiled_call(name, has_source)) { }
+
+    ~ProfiledCall() {
+        if (entered) {
+            context.leave_profiled_call();
+        }
+    }
+
+    ProfiledCall(const ProfiledCall&) = delete;
+    ProfiledCall& operator=(const ProfiledCall&) = delete;
+};
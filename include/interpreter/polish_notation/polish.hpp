@@ -43,7 +43,7 @@ class PolishNotationElement {
         return base_element.num_expressions;
     }
 
-    std::string get_data() const {
+    const std::string& get_data() const {
         return base_element.data;
     }
 
@@ -62,6 +62,10 @@ class PolishNotationElement {
         return base_element.type;
     }
 
+    const ParsedCodeElement& get_base_element() const {
+        return base_element;
+    }
+
     virtual void debug_print(std::ostream& os, const std::shared_ptr<ContextInterface>& context) const {
         os << "Executing PolishNotationElement(type=" << base_element.type << ", data=\"" << base_element.data
            << "\", position=" << base_element.position.get_original_position(context) << ", num_args=" << base_element.num_args
@@ -70,5 +74,30 @@ class PolishNotationElement {
 };
 
 
+/**
+ * @brief What a variable name stands for if there is no local variable of that name: a module constant, else the
+ * formal variable z.
+ *
+ * The module constants are fixed once the module register is built, so this is resolved once per register instead
+ * of on every use; values are immutable and can be shared.
+ */
+class UnboundVariableBinding {
+    const ModuleRegister* modules = nullptr;
+    std::shared_ptr<SymObject> value;
+
+ public:
+    const std::shared_ptr<SymObject>& resolve(const std::string& name, const std::shared_ptr<InterpreterContext>& context);
+};
+
+/**
+ * @brief The value of a variable: a local variable, else a module constant, else the formal variable z.
+ *
+ * @param name The name of the variable.
+ * @param context The interpreter context.
+ * @param binding The binding of the name if it is not a local variable.
+ */
+std::shared_ptr<SymObject> get_variable_value(const std::string& name, std::shared_ptr<InterpreterContext>& context,
+                                              UnboundVariableBinding& binding);
+
 std::shared_ptr<SymObjectContainer> iterate_wrapped(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
         std::shared_ptr<InterpreterContext>& context);
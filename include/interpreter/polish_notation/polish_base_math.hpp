@@ -17,43 +17,131 @@
 #include "types/sym_types/sym_void.hpp"
 
 
-inline std::shared_ptr<SymObject> binary_operation(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
-                                        std::shared_ptr<InterpreterContext>& context,
+/**
+ * @brief Applies a binary operation to two evaluated operands, which have to be mathematical objects.
+ */
+inline std::shared_ptr<SymObject> evaluate_math_operation(const std::shared_ptr<SymObject>& left_raw, const std::shared_ptr<SymObject>& right_raw,
                                         std::function<std::shared_ptr<SymMathObject>(std::shared_ptr<SymMathObject>, std::shared_ptr<SymMathObject>)> op
 ) {
-    std::shared_ptr<SymMathObject> left  = std::dynamic_pointer_cast<SymMathObject>(iterate_wrapped(cmd_list, context)->get_object());
-    std::shared_ptr<SymMathObject> right = std::dynamic_pointer_cast<SymMathObject>(iterate_wrapped(cmd_list, context)->get_object());
+    std::shared_ptr<SymMathObject> left  = std::dynamic_pointer_cast<SymMathObject>(left_raw);
+    std::shared_ptr<SymMathObject> right = std::dynamic_pointer_cast<SymMathObject>(right_raw);
     if (left == nullptr || right == nullptr) {
         throw ParsingTypeException("Type error: Expected mathematical object as argument");
     }
     return op(left, right);
 }
 
+inline std::shared_ptr<SymObject> binary_operation(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
+                                        std::shared_ptr<InterpreterContext>& context,
+                                        std::function<std::shared_ptr<SymMathObject>(std::shared_ptr<SymMathObject>, std::shared_ptr<SymMathObject>)> op
+) {
+    auto left  = iterate_wrapped(cmd_list, context)->get_object();
+    auto right = iterate_wrapped(cmd_list, context)->get_object();
+    return evaluate_math_operation(left, right, op);
+}
 
-class PolishPlus : public PolishNotationElement {
- public:
-    PolishPlus(ParsedCodeElement element) : PolishNotationElement(element) { }
+/**
+ * @brief Adds two mathematical objects or concatenates two strings.
+ *
+ * @param in_place Whether left is referenced nowhere else, such that it can be updated in place and returned.
+ */
+inline std::shared_ptr<SymObject> evaluate_plus(const std::shared_ptr<SymObject>& left, const std::shared_ptr<SymObject>& right,
+                                                const bool in_place = false) {
+    auto left_math = std::dynamic_pointer_cast<SymMathObject>(left);
+    auto right_math = std::dynamic_pointer_cast<SymMathObject>(right);
+
+    if (left_math && right_math) {
+        return in_place ? sym_add_in_place(left_math, right_math) : sym_add(left_math, right_math);
+    }
 
-    std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
-                                        std::shared_ptr<InterpreterContext>& context) {
-        auto left = iterate_wrapped(cmd_list, context)->get_object();
-        auto right = iterate_wrapped(cmd_list, context)->get_object();
+    auto left_string = std::dynamic_pointer_cast<SymStringObject>(left);
+    auto right_string = std::dynamic_pointer_cast<SymStringObject>(right);
 
-        auto left_math = std::dynamic_pointer_cast<SymMathObject>(left);
-        auto right_math = std::dynamic_pointer_cast<SymMathObject>(right);
+    if (left_string && right_string) {
+        if (in_place) {
+            left_string->append(right_string->to_string());
+            return left_string;
+        }
+        return std::make_shared<SymStringObject>(left_string->to_string() + right_string->to_string());
+    }
+
+    throw ParsingTypeException("Type error: Expected mathematical objects or strings as argument for addition");
+}
 
-        if (left_math && right_math) {
-            return std::make_shared<SymObjectContainer>(sym_add(left_math, right_math));
+/**
+ * @brief Raises base to an integer or, for doubles, a floating point exponent.
+ *
+ * @param position The position of the operator, for errors.
+ */
+inline std::shared_ptr<SymObject> evaluate_pow(const std::shared_ptr<SymObject>& base, const std::shared_ptr<SymObject>& exponent_raw,
+                                               const CodePlaceIdentifier& position) {
+    auto math_object = std::dynamic_pointer_cast<SymMathObject>(base);
+    if (!math_object) {
+        throw ParsingTypeException("Type error: Expected mathematical object as argument in pow");
+    }
+
+    auto exponent = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(exponent_raw);
+    if (exponent) {
+        auto value = exponent->as_value();
+        if (value.get_denominator() != BigInt(1)) {
+            throw EvalException("Expected number as exponent", position);  // TODO(vabi) also throw position in original string AND the violating string
         }
+        auto result = std::dynamic_pointer_cast<SymMathObject>(math_object->clone());
+        result->pow(value.get_numerator());
+        return result;
+    }
 
-        auto left_string = std::dynamic_pointer_cast<SymStringObject>(left);
-        auto right_string = std::dynamic_pointer_cast<SymStringObject>(right);
+    auto exponent_double = std::dynamic_pointer_cast<ValueType<double>>(exponent_raw);
+    if (exponent_double) {
+        auto math_double_object = std::dynamic_pointer_cast<ValueType<double>>(math_object);
+        if (math_double_object) {
+            auto result = std::dynamic_pointer_cast<ValueType<double>>(math_double_object->clone());
+            result->pow(exponent_double->as_value());
+            return result;
+        }
 
-        if (left_string && right_string) {
-            return std::make_shared<SymObjectContainer>(std::make_shared<SymStringObject>(left_string->to_string() + right_string->to_string()));
+        auto math_rational_object = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(math_object);
+        if (math_rational_object) {
+            double value = math_rational_object->as_value().get_numerator().as_double()/math_rational_object->as_value().get_denominator().as_double();
+            value = std::pow(value, exponent_double->as_value());
+            return std::make_shared<ValueType<double>>(value);
         }
 
-        throw ParsingTypeException("Type error: Expected mathematical objects or strings as argument for addition");
+
+        throw ParsingTypeException("Type error: Expected mathematical object as base in pow");
+    }
+
+    throw ParsingTypeException("Type error: Expected number as exponent in pow");
+}
+
+inline std::shared_ptr<SymObject> evaluate_unary_minus(const std::shared_ptr<SymObject>& value) {
+    auto math_type = std::dynamic_pointer_cast<SymMathObject>(value);
+    if (math_type) {
+        auto negated = std::dynamic_pointer_cast<SymMathObject>(math_type->clone());
+        negated->unary_minus();
+        return negated;
+    }
+    throw ParsingTypeException("Type error: Expected mathematical object as argument");
+}
+
+inline std::shared_ptr<SymObject> evaluate_unary_plus(const std::shared_ptr<SymObject>& value) {
+    auto math_type = std::dynamic_pointer_cast<SymMathObject>(value);
+    if (math_type) {
+        return math_type;
+    }
+    throw ParsingTypeException("Type error: Expected mathematical object as argument");
+}
+
+
+class PolishPlus : public PolishNotationElement {
+ public:
+    PolishPlus(ParsedCodeElement element) : PolishNotationElement(element) { }
+
+    std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
+                                        std::shared_ptr<InterpreterContext>& context) {
+        auto left = iterate_wrapped(cmd_list, context)->get_object();
+        auto right = iterate_wrapped(cmd_list, context)->get_object();
+        return std::make_shared<SymObjectContainer>(evaluate_plus(left, right));
     }
 };
 
@@ -93,45 +181,12 @@ class PolishPow: public PolishNotationElement {
 
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                         std::shared_ptr<InterpreterContext>& context) {
-        auto left  = iterate_wrapped(cmd_list, context)->get_object();
-        auto math_object = std::dynamic_pointer_cast<SymMathObject>(left);
-        if (!math_object) {
+        auto base = iterate_wrapped(cmd_list, context)->get_object();
+        if (!std::dynamic_pointer_cast<SymMathObject>(base)) {  // reported before the exponent is evaluated
             throw ParsingTypeException("Type error: Expected mathematical object as argument in pow");
         }
-        // TODO(vabi) check for emptyness
-        auto exponent_raw = iterate_wrapped(cmd_list, context)->get_object();
-
-        auto exponent = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(exponent_raw);
-        if (exponent) {
-            auto value = exponent->as_value();
-            if (value.get_denominator() != BigInt(1)) {
-                throw EvalException("Expected number as exponent", this->get_position());  // TODO(vabi) also throw position in original string AND the violating string
-            }
-            math_object->pow(value.get_numerator());
-            return std::make_shared<SymObjectContainer>(math_object);
-        }
-
-        auto exponent_double = std::dynamic_pointer_cast<ValueType<double>>(exponent_raw);
-        if (exponent_double) {
-            auto math_double_object = std::dynamic_pointer_cast<ValueType<double>>(math_object);
-            if (math_double_object) {
-                math_double_object->pow(exponent_double->as_value());
-                return std::make_shared<SymObjectContainer>(math_double_object);
-            }
-
-            auto math_rational_object = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(math_object);
-            if (math_rational_object) {
-                double value = math_rational_object->as_value().get_numerator().as_double()/math_rational_object->as_value().get_denominator().as_double();
-                value = std::pow(value, exponent_double->as_value());
-                return std::make_shared<SymObjectContainer>(std::make_shared<ValueType<double>>(value));
-            }
-
-
-            throw ParsingTypeException("Type error: Expected mathematical object as base in pow");
-        }
-
-        throw ParsingTypeException("Type error: Expected number as exponent in pow");
-        return nullptr;
+        auto exponent = iterate_wrapped(cmd_list, context)->get_object();
+        return std::make_shared<SymObjectContainer>(evaluate_pow(base, exponent, this->get_position()));
     }
 };
 
@@ -143,14 +198,7 @@ class PolishUnaryMinus: public PolishNotationElement {
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                         std::shared_ptr<InterpreterContext>& context) {
         auto result = iterate_wrapped(cmd_list, context)->get_object();
-        auto math_type = std::dynamic_pointer_cast<SymMathObject>(result);
-        if (math_type) {
-            math_type->unary_minus();
-            return std::make_shared<SymObjectContainer>(math_type);
-        }
-        throw ParsingTypeException("Type error: Expected mathematical object as argument");
-
-        return nullptr;
+        return std::make_shared<SymObjectContainer>(evaluate_unary_minus(result));
     }
 };
 
@@ -161,11 +209,7 @@ class PolishUnaryPlus: public PolishNotationElement {
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                         std::shared_ptr<InterpreterContext>& context) {
         auto result = iterate_wrapped(cmd_list, context)->get_object();
-        auto math_type = std::dynamic_pointer_cast<SymMathObject>(result);
-        if (math_type) {
-            return std::make_shared<SymObjectContainer>(math_type);
-        }
-        throw ParsingTypeException("Type error: Expected mathematical object as argument");
+        return std::make_shared<SymObjectContainer>(evaluate_unary_plus(result));
     }
 };
 
@@ -0,0 +1,91 @@
+/**
+ * @file polish_bytecode.hpp
+ * @brief Compilation of programs in polish notation to bytecode for a stack machine, and its execution.
+ */
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/lexer_deque.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/context.hpp"
+
+class PolishCustomFunction;
+
+#define NO_SLOT UINT32_MAX  // argument of an operator updating a variable without a slot
+
+enum BytecodeOperation: uint8_t {
+    PUSH_CONSTANT,      // pushes constant
+    LOAD_VARIABLE,      // pushes the variable, module constant or formal variable name
+    STORE_VARIABLE,     // assigns the top of the stack to the variable name, keeping the value on the stack
+    LOAD_LOCAL,         // pushes the local variable in slot argument, or if it is unassigned, like LOAD_VARIABLE
+    STORE_LOCAL,        // assigns the top of the stack to the local variable in slot argument, keeping it on the stack
+    POP,
+    ADD,                // the arithmetic operators update the left operand in place if nothing else refers to it
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    POWER,
+    NEGATE,
+    PLUS_SIGN,          // unary plus, which only checks for a mathematical object
+    CALL_MODULE,        // calls the module function of element on the top num_args values
+    PREPARE_CALL,       // looks up the custom function of element; if it is undefined, jumps to target, the fallback
+    CALL_FUNCTION,      // calls the looked up custom function on the top num_args values
+    SUBSCRIPT,          // replaces target and index on the stack by target[index]
+    LOAD_SUBSCRIPT_TARGET,  // pops target and index and looks up target[index] for a following STORE_SUBSCRIPT
+    STORE_SUBSCRIPT,    // assigns the top of the stack to the looked up target[index], keeping the value on the stack
+    JUMP,               // jumps to target
+    JUMP_IF_FALSE,      // pops a boolean condition and jumps to target if it is false
+    CHECK_CONDITION,    // pops a condition, which has to be a boolean
+    ENTER_LOOP,         // invalidates the loop invariants of the loop element
+    FOR_INIT,           // pops the bounds of a for loop
+    FOR_NEXT,           // pushes the next value of the loop variable, or ends the loop and jumps to target
+    EVALUATE_ELEMENT,   // pushes the value of an element without operands
+    EVALUATE_FALLBACK   // pushes the value of the fallback argument, evaluated by the tree walker
+};
+
+/**
+ * @brief A single instruction; the element it was compiled from provides the position for errors.
+ */
+struct BytecodeInstruction {
+    BytecodeOperation operation;
+    uint32_t argument;  // jump target, slot or index of the fallback
+    std::shared_ptr<PolishNotationElement> element;
+    std::shared_ptr<SymObject> constant;
+    std::string name;  // variable name for loads and stores, and for operators the variable they update, if any
+    mutable PolishCustomFunction* function;  // custom function of a call, cached once it is defined; owned by the context
+    mutable UnboundVariableBinding binding;  // value of a loaded name that is not a local variable
+};
+
+/**
+ * @brief A compiled program; the jumps are resolved to instruction indices.
+ *
+ * Expressions without a dedicated instruction, like function definitions and setparam, are kept in polish notation
+ * as fallbacks and handed to the tree walker.
+ */
+struct BytecodeProgram {
+    std::vector<BytecodeInstruction> code;
+    std::vector<LexerDeque<std::shared_ptr<PolishNotationElement>>> fallbacks;
+};
+
+/**
+ * @brief Compiles a program.
+ *
+ * @param program The program in polish notation.
+ * @param context The interpreter context.
+ * @param layout The slots of the local variables if the program is the body of a custom function; the variables
+ *               assigned in the body are added to it. nullptr if all variables are accessed by name.
+ * @return The compiled program, or nullptr if the structure of the program cannot be recovered. Such programs
+ *         are executed by the tree walker, which reports the error.
+ */
+std::shared_ptr<BytecodeProgram> compile_bytecode(const LexerDeque<std::shared_ptr<PolishNotationElement>>& program,
+                                                  std::shared_ptr<InterpreterContext>& context,
+                                                  const std::shared_ptr<FrameLayout>& layout = nullptr);
+
+/**
+ * @brief Executes a compiled program.
+ *
+ * @return The value of the last statement of the program.
+ */
+std::shared_ptr<SymObject> run_bytecode(const BytecodeProgram& program, std::shared_ptr<InterpreterContext>& context);
@@ -3,23 +3,84 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "common/lexer_deque.hpp"
 #include "interpreter/polish_notation/polish.hpp"
 #include "interpreter/polish_notation/polish_base_math.hpp"
 #include "interpreter/polish_notation/polish_function_core.hpp"
+#include "interpreter/polish_notation/polish_optimized.hpp"
 #include "exceptions/invalid_function_arg_exception.hpp"
 #include "exceptions/parsing_exceptions.hpp"
 #include "exceptions/eval_exception.hpp"
 #include "types/sym_types/sym_void.hpp"
 #include "types/sym_types/sym_boolean.hpp"
 
-class PolishFor: public PolishFunction {
+/**
+ * @brief The bounds of a for loop, which have to be integers within int64 range.
+ *
+ * @param position The position of the loop variable, for errors.
+ */
+inline std::pair<int64_t, int64_t> get_for_loop_bounds(const std::shared_ptr<SymObject>& start_object, const std::shared_ptr<SymObject>& end_object,
+                                                       const CodePlaceIdentifier& position) {
+    auto start  = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(start_object);
+    auto end    = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(end_object);
+
+    if (!start || !end) {
+        throw EvalException("Expected integer start and end values in for loop", position);
+    }
+
+    if (start->as_value().get_denominator() != BigInt(1) || end->as_value().get_denominator() != BigInt(1)) {
+        throw EvalException("Expected integer start and end values in for loop, found a non-integer rational", position);
+    }
+
+    auto start_v = start->as_value().get_numerator();
+    auto end_v   = end->as_value().get_numerator();
+    int64_t start_idx, end_idx;
+
+    try {  // TODO(vabi): allow bigints as for loop bounds
+        start_idx = start_v.as_int64();
+        end_idx = end_v.as_int64();
+    } catch (const std::runtime_error&) {
+        throw EvalException("Start and end values in for loop must be within int64 range", position);
+    }
+
+    return std::make_pair(start_idx, end_idx);
+}
+
+/**
+ * @brief Base class of the loops, which own the loop-invariant expressions hoisted out of them.
+ */
+class PolishLoop: public PolishFunction {
+    std::vector<std::shared_ptr<PolishLoopInvariant>> loop_invariants;
+
+ public:
+    PolishLoop(ParsedCodeElement element, uint32_t min_num_args, uint32_t max_num_args) :
+        PolishFunction(element, min_num_args, max_num_args) { }
+
+    /**
+     * @brief Drops the cached loop invariants; called whenever the loop is entered.
+     */
+    void invalidate_loop_invariants() {
+        for (auto& invariant : loop_invariants) {
+            invariant->invalidate();
+        }
+    }
+
+    void add_loop_invariant(std::shared_ptr<PolishLoopInvariant> invariant) {
+        loop_invariants.push_back(invariant);
+    }
+};
+
+class PolishFor: public PolishLoop {
  public:
     PolishFor(ParsedCodeElement element) :
-        PolishFunction(element, 3, UINT32_MAX) { }
+        PolishLoop(element, 3, UINT32_MAX) { }
 
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                         std::shared_ptr<InterpreterContext>& context) {
+        invalidate_loop_invariants();
         auto variable = cmd_list.front();
         cmd_list.pop_front();
         if (variable->get_type() != VARIABLE) {
@@ -29,27 +90,8 @@ class PolishFor: public PolishFunction {
         auto loop_index_var_name = variable->get_data();
         auto s = iterate_wrapped(cmd_list, context)->get_object();
         auto e = iterate_wrapped(cmd_list, context)->get_object();
-        auto start  = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(s);
-        auto end    = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(e);
-
-        if (!start || !end) {
-            throw EvalException("Expected integer start and end values in for loop", variable->get_position());
-        }
-
-        if (start->as_value().get_denominator() != BigInt(1) || end->as_value().get_denominator() != BigInt(1)) {
-            throw EvalException("Expected integer start and end values in for loop, found a non-integer rational", variable->get_position());
-        }
-
-        auto start_v = start->as_value().get_numerator();
-        auto end_v   = end->as_value().get_numerator();
         int64_t start_idx, end_idx;
-
-        try {  // TODO(vabi): allow bigints as for loop bounds
-            start_idx = start_v.as_int64();
-            end_idx = end_v.as_int64();
-        } catch (const std::runtime_error& e) {
-            throw EvalException("Start and end values in for loop must be within int64 range", variable->get_position());
-        }
+        std::tie(start_idx, end_idx) = get_for_loop_bounds(s, e, variable->get_position());
 
         auto next = cmd_list.peek();
         if (!next || next.value()->get_type() != SCOPE_START) {
@@ -59,7 +101,7 @@ class PolishFor: public PolishFunction {
         auto subexpressions = next.value()->get_sub_expressions();
 
         for (int64_t i = start_idx; i <= end_idx; i++) {
-            context->set_variable(loop_index_var_name, std::make_shared<ValueType<RationalNumber<BigInt>>>(RationalNumber<BigInt>(BigInt(i), BigInt(1))));
+            context->set_variable(loop_index_var_name, make_small_integer(i));
             while (!subexpressions.is_empty()) {
                 iterate_wrapped(subexpressions, context);
             }
@@ -70,13 +112,14 @@ class PolishFor: public PolishFunction {
     }
 };
 
-class PolishWhile: public PolishFunction {
+class PolishWhile: public PolishLoop {
  public:
     PolishWhile(ParsedCodeElement element) :
-        PolishFunction(element, 1, UINT32_MAX) { }
+        PolishLoop(element, 1, UINT32_MAX) { }
 
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                         std::shared_ptr<InterpreterContext>& context) {
+        invalidate_loop_invariants();
         uint32_t original_index  = cmd_list.get_index();
 
         while (true) {
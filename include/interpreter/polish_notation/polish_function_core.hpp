@@ -7,7 +7,9 @@
 #include <queue>
 #include "common/lexer_deque.hpp"
 #include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/polish_notation/polish_bytecode.hpp"
 #include "exceptions/invalid_function_arg_exception.hpp"
+#include "exceptions/eval_exception.hpp"
 
 class PolishFunction: public PolishNotationElement {
  public:
@@ -23,9 +25,30 @@ class PolishFunction: public PolishNotationElement {
 };
 
 class PolishCustomFunction: public PolishFunction {
+    std::shared_ptr<BytecodeProgram> compiled_body;  // compiled on the first call; nullptr if the body cannot be compiled
+    std::shared_ptr<FrameLayout> frame_layout;
+    std::vector<uint32_t> arg_slots;
+    bool body_compiled;
+
+    /**
+     * @brief Compiles the body, with the arguments and the variables assigned in the body resolved to slots.
+     */
+    void compile_body(std::shared_ptr<InterpreterContext>& context) {
+        body_compiled = true;
+        frame_layout = std::make_shared<FrameLayout>();
+        for (const auto& name : arg_names) {
+            if (context->is_constant(name)) {
+                return;  // the tree walker reports the assignment to the constant
+            }
+            arg_slots.push_back(frame_layout->add_variable(name));
+        }
+        compiled_body = compile_bytecode(get_sub_expressions(), context, frame_layout);
+    }
+
  public:
     std::vector<std::string> arg_names;
-    PolishCustomFunction(ParsedCodeElement element) : PolishFunction(element, 0, UINT32_MAX) {}
+    PolishCustomFunction(ParsedCodeElement element) : PolishFunction(element, 0, UINT32_MAX), compiled_body(nullptr), frame_layout(nullptr),
+                                                      body_compiled(false) {}
 
     std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                     std::shared_ptr<InterpreterContext>& context) override {
@@ -70,31 +93,72 @@ class PolishCustomFunction: public PolishFunction {
                 arg_values.push_back(arg_value);
             }
 
-            context->push_variables();
+            return std::make_shared<SymObjectContainer>(existing_func->call(arg_values, context));
+        }
+    }
 
-            for (uint32_t ind = 0; ind < existing_func->arg_names.size(); ind++) {
-                context->set_variable(existing_func->arg_names[ind], arg_values[ind]);
-            }
+    /**
+     * @brief Executes the function body with already evaluated arguments in a new variable scope.
+     *
+     * @param arg_values The argument values, one per argument name.
+     * @param context The interpreter context.
+     * @return The value of the last expression of the body.
+     */
+    std::shared_ptr<SymObject> call(const std::vector<std::shared_ptr<SymObject>>& arg_values, std::shared_ptr<InterpreterContext>& context) {
+        return call(arg_values.data(), arg_values.size(), context);
+    }
 
-            // This is a bit subtle for recursive calls.
-            // The way we store the data (as a shared_ptr) in the lexer deque,
-            // the data is always the *SAME*, but the index is *COPIED* in the line below,
-            // so each call stack has its own index.
-            // This avoids unnecessary copying of the data while still allowing recursive calls.
-            auto subexpressions = existing_func->get_sub_expressions();
+    /**
+     * @brief Overload for argument values stored contiguously, like on the stack of the bytecode machine.
+     */
+    std::shared_ptr<SymObject> call(const std::shared_ptr<SymObject>* arg_values, size_t num_args, std::shared_ptr<InterpreterContext>& context) {
+        if (num_args != arg_names.size()) {
+            throw EvalException("Function " + get_data() + " called with incorrect number of arguments: "+std::to_string(num_args)+
+                ", expected " + std::to_string(arg_names.size()), this->get_position());
+        }
+        auto profiled = ProfiledCall(*context, get_data(), true);
 
-            std::shared_ptr<SymObject> ret = std::make_shared<SymVoidObject>();
-            while (!subexpressions.is_empty()) {
-                ret = iterate_wrapped(subexpressions, context)->get_object();
+        if (context->get_shell_parameters().bytecode_execution) {
+            if (!body_compiled) {
+                compile_body(context);
+            }
+            if (compiled_body) {
+                context->push_variables(frame_layout);
+                for (uint32_t ind = 0; ind < num_args; ind++) {
+                    context->set_local(arg_slots[ind], arg_values[ind]);
+                }
+                auto ret = run_bytecode(*compiled_body, context);
+                context->pop_variables();
+                return ret;
             }
-            context->pop_variables();
-            subexpressions.set_index(0);
-            return std::make_shared<SymObjectContainer>(ret);
         }
+
+        context->push_variables();
+
+        for (uint32_t ind = 0; ind < arg_names.size(); ind++) {
+            context->set_variable(arg_names[ind], arg_values[ind]);
+        }
+
+        // This is a bit subtle for recursive calls.
+        // The way we store the data (as a shared_ptr) in the lexer deque,
+        // the data is always the *SAME*, but the index is *COPIED* in the line below,
+        // so each call stack has its own index.
+        // This avoids unnecessary copying of the data while still allowing recursive calls.
+        auto subexpressions = get_sub_expressions();
+
+        std::shared_ptr<SymObject> ret = std::make_shared<SymVoidObject>();
+        while (!subexpressions.is_empty()) {
+            ret = iterate_wrapped(subexpressions, context)->get_object();
+        }
+        context->pop_variables();
+        subexpressions.set_index(0);
+        return ret;
     }
 };
 
 class PolishModuleFunction: public PolishFunction {
+    const ModuleRegister* bound_register = nullptr;  // the register the function was bound in
+    const ModuleFunction* bound_function = nullptr;  // nullptr if the path does not name a module function
  public:
     PolishModuleFunction(ParsedCodeElement element): PolishFunction(element, 0, UINT32_MAX) { }
 
@@ -105,19 +169,40 @@ class PolishModuleFunction: public PolishFunction {
                 auto arg_value = iterate_wrapped(cmd_list, context);
                 arg_values.push_back(arg_value);
             }
+            return call(arg_values, context);
+        }
 
+    /**
+     * @brief Calls the module function with already evaluated arguments.
+     *
+     * @param arg_values The argument values.
+     * @param context The interpreter context.
+     * @return The result of the module function.
+     */
+    std::shared_ptr<SymObjectContainer> call(std::vector<std::shared_ptr<SymObjectContainer>>& arg_values,
+                                             std::shared_ptr<InterpreterContext>& context) {
+        auto profiled = ProfiledCall(*context, get_data(), false);
+        auto& modules = context->get_module_register();
+        if (bound_register != &modules) {
+            bound_register = &modules;
+            bound_function = modules.find_module_function(get_data());
+        }
+        try {
+            if (bound_function) {
+                return bound_function->call(arg_values, std::static_pointer_cast<ModuleContextInterface>(context));
+            }
+            // not a module function; the lookup along the path reports which part is missing
             auto module_path = std::queue<std::string>();
             auto parts = string_split(get_data(), '.');
             for (const auto& part : parts) {
                 module_path.push(part);
             }
-            try {
-                return context->get_module_register().call_module_function(
-                    module_path, arg_values, std::static_pointer_cast<ModuleContextInterface>(context));
-            } catch(ParsingTypeException& e) {
-                throw EvalException(std::string("Type error when calling module function: ") + e.what(), this->get_position());
-            } catch (std::exception& e) {
-                throw EvalException(std::string("Error calling module function: ") + e.what(), this->get_position());
-            }
+            return modules.call_module_function(
+                module_path, arg_values, std::static_pointer_cast<ModuleContextInterface>(context));
+        } catch(ParsingTypeException& e) {
+            throw EvalException(std::string("Type error when calling module function: ") + e.what(), this->get_position());
+        } catch (std::exception& e) {
+            throw EvalException(std::string("Error calling module function: ") + e.what(), this->get_position());
         }
+    }
 };
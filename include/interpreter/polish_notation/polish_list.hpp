@@ -15,8 +15,8 @@
 #include "types/sym_types/sym_string_object.hpp"
 #include "types/sym_types/math_types/value_type.hpp"
 
-BigInt parse_index(const std::shared_ptr<SymObjectContainer>& index_container) {
-    auto index = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(index_container->get_object());
+inline BigInt parse_index(const std::shared_ptr<SymObject>& index_object) {
+    auto index = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(index_object);
     if (!index) {
         throw ParsingTypeException("Type error: Expected natural number as index in subscript");
     }
@@ -34,6 +34,34 @@ BigInt parse_index(const std::shared_ptr<SymObjectContainer>& index_container) {
     return idx;
 }
 
+/**
+ * @brief The container of target[index], for reading as well as assigning.
+ *
+ * @param target The list or dict.
+ * @param index The index; a natural number for lists, any key for dicts.
+ */
+inline std::shared_ptr<SymObjectContainer> access_subscript(const std::shared_ptr<SymObject>& target, const std::shared_ptr<SymObject>& index) {
+    auto list_ptr = std::dynamic_pointer_cast<SymListObject>(target);
+    if (list_ptr) {
+        int64_t index_int;
+        if (!get_small_integer(*index, index_int) || index_int < 0) {
+            index_int = parse_index(index).as_int64();
+        }
+        return list_ptr->at(index_int);
+    }
+
+    auto dict_ptr = std::dynamic_pointer_cast<SymDictObject>(target);
+    if (dict_ptr) {
+        if (dict_ptr->has_key(index)) {
+            return dict_ptr->get(index);
+        } else {
+            return std::make_shared<SymTempDictObjectContainer>(dict_ptr, index);
+        }
+    }
+
+    throw ParsingTypeException("Type error: Expected list or dict as target of subscript operator");
+}
+
 class PolishArrayAccess: public PolishNotationElement {
  public:
     PolishArrayAccess(ParsedCodeElement element): PolishNotationElement(element) {}
@@ -47,22 +75,7 @@ class PolishArrayAccess: public PolishNotationElement {
             throw ParsingException("Unexpected extra tokens in array access", get_position());
         }
 
-        auto list_ptr = std::dynamic_pointer_cast<SymListObject>(variable->get_object());
-        if (list_ptr) {
-            auto index_int = parse_index(index).as_int64();
-            return list_ptr->at(index_int);
-        }
-
-        auto dict_ptr = std::dynamic_pointer_cast<SymDictObject>(variable->get_object());
-        if (dict_ptr) {
-            if (dict_ptr->has_key(index->get_object())) {
-                return dict_ptr->get(index->get_object());
-            } else {
-                return std::make_shared<SymTempDictObjectContainer>(dict_ptr, index->get_object());
-            }
-        }
-
-        throw ParsingTypeException("Type error: Expected list or dict as target of subscript operator");
+        return access_subscript(variable->get_object(), index->get_object());
     }
 };
 
@@ -0,0 +1,80 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/lexer_deque.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/context.hpp"
+
+/**
+ * @brief A value computed by the optimisation pass before execution, standing in for a constant subexpression.
+ */
+class PolishConstant: public PolishNotationElement {
+    std::shared_ptr<SymObject> value;
+
+ public:
+    PolishConstant(ParsedCodeElement element, std::shared_ptr<SymObject> value): PolishNotationElement(element), value(value) { }
+
+    std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
+                                    std::shared_ptr<InterpreterContext>& context) override {
+        UNUSED(cmd_list);
+        UNUSED(context);
+        return std::make_shared<SymObjectContainer>(value);
+    }
+};
+
+/**
+ * @brief A loop-invariant expression, evaluated at most once per execution of the loop owning it.
+ *
+ * The loop invalidates the cached value whenever it is entered. Since a recursive call may enter the same loop
+ * again, the value is only reused in the variable scope it was computed in. It is not cached at all if it or one
+ * of the variables it reads can be modified in place, as then an unchanged variable binding does not imply an
+ * unchanged value.
+ */
+class PolishLoopInvariant: public PolishNotationElement {
+    std::vector<std::string> variable_names;
+    std::shared_ptr<SymObject> cached_value;
+    size_t cached_scope_depth;
+
+    bool reads_only_immutable_values(std::shared_ptr<InterpreterContext>& context) {
+        for (const auto& name : variable_names) {
+            auto value = context->get_variable(name);
+            if (value && value->modifiable_in_place()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+ public:
+    /**
+     * @param element The root element of the expression, used for its position.
+     * @param expression The expression in polish notation.
+     * @param variable_names The variables read by the expression.
+     */
+    PolishLoopInvariant(ParsedCodeElement element, LexerDeque<std::shared_ptr<PolishNotationElement>> expression,
+                        std::vector<std::string> variable_names): PolishNotationElement(element),
+                        variable_names(variable_names), cached_value(nullptr), cached_scope_depth(0) {
+        set_sub_expressions(expression);
+    }
+
+    void invalidate() {
+        cached_value = nullptr;
+    }
+
+    std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
+                                    std::shared_ptr<InterpreterContext>& context) override {
+        UNUSED(cmd_list);
+        if (cached_value && cached_scope_depth == context->get_scope_depth()) {
+            return std::make_shared<SymObjectContainer>(cached_value);
+        }
+
+        auto expression = get_sub_expressions();
+        auto value = iterate_wrapped(expression, context)->get_object();
+        if (!value->modifiable_in_place() && reads_only_immutable_values(context)) {
+            cached_value = value;
+            cached_scope_depth = context->get_scope_depth();
+        }
+        return std::make_shared<SymObjectContainer>(value);
+    }
+};
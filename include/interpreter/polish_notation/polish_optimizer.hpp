@@ -0,0 +1,28 @@
+/**
+ * @file polish_optimizer.hpp
+ * @brief Optimisation pass over programs in polish notation.
+ */
+#pragma once
+#include <memory>
+#include "common/lexer_deque.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/context.hpp"
+
+#define POLISH_INLINE_MAX_SIZE 32  // maximal number of elements of a function body to be inlined
+
+/**
+ * @brief Optimises a program in polish notation before its execution.
+ *
+ * Depending on the shell parameters, the pass
+ * - inlines calls of small non-recursive functions whose body is a single pure expression,
+ * - folds pure subexpressions with constant arguments, including math and powerseries functions, into their values,
+ * - hoists pure loop-invariant expressions out of while and for loops.
+ * Programs the pass cannot make sense of, for example due to syntax errors, are returned unchanged, such that
+ * errors are reported at runtime as before.
+ *
+ * @param program The program as produced from the shunting yard output.
+ * @param context The interpreter context the program will be executed in.
+ * @return The optimised program.
+ */
+LexerDeque<std::shared_ptr<PolishNotationElement>> optimize_polish_program(const LexerDeque<std::shared_ptr<PolishNotationElement>>& program,
+                                                                            std::shared_ptr<InterpreterContext>& context);
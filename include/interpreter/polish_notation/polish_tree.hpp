@@ -0,0 +1,63 @@
+/**
+ * @file polish_tree.hpp
+ * @brief Syntax trees of programs in polish notation, for the passes operating on whole programs.
+ */
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "common/lexer_deque.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+
+enum PolishNodeKind {
+    CONSTANT_NODE,
+    VARIABLE_NODE,
+    OPERATOR_NODE,
+    MODULE_CALL_NODE,
+    ASSIGN_NODE,
+    FOR_NODE,
+    WHILE_NODE,
+    IF_NODE,
+    DEFINITION_NODE,
+    CALL_NODE,
+    SUBSCRIPT_NODE,
+    SCOPE_NODE,
+    OTHER_NODE
+};
+
+/**
+ * @brief An element of a program together with the operands it consumes at runtime.
+ *
+ * The children of a for loop are the loop variable, the bounds and the scope; those of while, if and elif the
+ * condition, the scope and possibly the following elif; those of a function definition the argument names and
+ * the scope.
+ */
+struct PolishNode {
+    PolishNodeKind kind;
+    std::shared_ptr<PolishNotationElement> element;
+    std::vector<PolishNode> children;
+    std::vector<PolishNode> block;  // the statements of a scope, or the index of a subscript
+};
+
+/**
+ * @brief Thrown when the structure of a program cannot be recovered, in which case it is executed as it is.
+ */
+class PolishTreeException: public std::runtime_error {
+ public:
+    explicit PolishTreeException(const std::string& message): std::runtime_error(message) { }
+};
+
+/**
+ * @brief Splits a program into the syntax trees of its expressions.
+ *
+ * @param program The program.
+ * @param statements Whether the expressions are statements, where function definitions can occur.
+ * @throws PolishTreeException if the program is malformed.
+ */
+std::vector<PolishNode> parse_polish_tree(LexerDeque<std::shared_ptr<PolishNotationElement>> program, bool statements);
+
+/**
+ * @brief Flattens syntax trees into a program again; the scopes and subscripts get their blocks as sub expressions.
+ */
+LexerDeque<std::shared_ptr<PolishNotationElement>> serialize_polish_tree(const std::vector<PolishNode>& block);
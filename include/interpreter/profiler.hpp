@@ -0,0 +1,160 @@
+/**
+ * @file profiler.hpp
+ * @brief Sampling profiler attributing time and steps to source lines, custom functions and module functions.
+ */
+#pragma once
+#include <signal.h>
+#include <stdint.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "common/file_location.hpp"
+
+#define PROFILER_SAMPLE_INTERVAL_US 1000  // CPU time between two samples
+#define PROFILER_REPORT_ENTRIES 20  // rows per table of the report printed with profile_output
+
+/**
+ * @brief Set by the profiling timer when a sample is due; the interpreter checks it once per step, so the profiler
+ * costs next to nothing between samples.
+ */
+extern volatile sig_atomic_t profiler_sample_due;
+
+/**
+ * @brief Time and steps attributed to a function, a line or a stack.
+ */
+struct ProfileCounts {
+    uint64_t samples = 0;
+    uint64_t microseconds = 0;
+    uint64_t steps = 0;
+
+    void add(uint64_t elapsed_microseconds, uint64_t elapsed_steps) {
+        samples++;
+        microseconds += elapsed_microseconds;
+        steps += elapsed_steps;
+    }
+};
+
+/**
+ * @brief Inclusive counts contain the time spent in callees, exclusive counts do not.
+ */
+struct ProfileEntry {
+    ProfileCounts inclusive;
+    ProfileCounts exclusive;
+};
+
+/**
+ * @brief A call on the stack of the profiled program.
+ */
+struct ProfilerFrame {
+    const std::string* name;  // owned by the called function, which outlives the call
+    const CodePlaceIdentifier* call_site;  // the position in the caller; nullptr if unknown
+    bool has_source;  // false for module functions, which have no lines of their own
+};
+
+/**
+ * @class SourceLines
+ * @brief Maps positions to labels "file:line" of the original source; files are read from disk when first needed.
+ */
+class SourceLines {
+    std::map<std::string, std::vector<uint32_t>> line_starts;  // the offsets at which the lines of each file start
+
+ public:
+    /**
+     * @brief Sets the content of a source file, for inputs which are not read from disk, like those of the repl.
+     */
+    void set_source(const std::string& file_name, const std::string& content);
+
+    std::string get_label(const CodePlaceIdentifier& position, const std::shared_ptr<ContextInterface>& context);
+};
+
+/**
+ * @class SamplingProfiler
+ * @brief Samples the stack of calls and the executed line at regular intervals of CPU time.
+ *
+ * Each sample is weighted with the time and the steps since the previous one. The samples accumulate until the
+ * profiler is destroyed, also over several evaluations. Only one profiler can run at a time, as the timer is
+ * process wide.
+ */
+class SamplingProfiler {
+    std::vector<ProfilerFrame> frames;
+    std::map<std::string, ProfileCounts> stacks;
+    std::map<std::string, ProfileEntry> functions;
+    std::map<std::string, ProfileEntry> lines;
+    SourceLines sources;
+    std::chrono::steady_clock::time_point last_sample;
+    uint64_t last_sample_steps;
+    bool running;
+
+ public:
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    /**
+     * @brief Arms the timer.
+     *
+     * @param steps The current step count of the interpreter.
+     */
+    void start(uint64_t steps);
+
+    /**
+     * @brief Disarms the timer; the time since the last sample is not recorded.
+     */
+    void stop();
+
+    bool is_running() const {
+        return running;
+    }
+
+    void set_source(const std::string& file_name, const std::string& content) {
+        sources.set_source(file_name, content);
+    }
+
+    void enter(const std::string& name, const CodePlaceIdentifier* call_site, bool has_source) {
+        frames.push_back(ProfilerFrame{&name, call_site, has_source});
+    }
+
+    /**
+     * @return The position in the caller at the time of the call.
+     */
+    const CodePlaceIdentifier* leave() {
+        auto call_site = frames.back().call_site;
+        frames.pop_back();
+        return call_site;
+    }
+
+    /**
+     * @brief Records a sample.
+     *
+     * @param position The position last executed in the innermost function with source; nullptr if unknown.
+     * @param steps The current step count of the interpreter.
+     * @param context The context, which maps positions to the original source files.
+     */
+    void record_sample(const CodePlaceIdentifier* position, uint64_t steps, const std::shared_ptr<ContextInterface>& context);
+
+    /**
+     * @brief Writes one line "frame;frame;... weight" per sampled stack, weighted in microseconds, as read by
+     * flamegraph tools. Frames with source are labelled with the line executed in them.
+     */
+    void write_collapsed_stacks(std::ostream& stream) const;
+
+    /**
+     * @brief Writes tables of the functions and lines taking the most exclusive time.
+     *
+     * @param max_entries The maximal number of rows per table.
+     */
+    void write_report(std::ostream& stream, size_t max_entries) const;
+
+    const std::map<std::string, ProfileEntry>& get_functions() const {
+        return functions;
+    }
+
+    const std::map<std::string, ProfileEntry>& get_lines() const {
+        return lines;
+    }
+};
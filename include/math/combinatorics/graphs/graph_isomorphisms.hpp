@@ -9,8 +9,13 @@
 #include <numeric>
 #include <string>
 #include <functional>
+#include <algorithm>
 #include "types/ring_helpers.hpp"
+#include "cpp_utils/unused.hpp"
 #include "types/power_series.hpp"
+#include "math_utils/factorial_generator.hpp"
+#include "math/combinatorics/polya/partitions.hpp"
+#include "math/combinatorics/symbolic_method/unlabelled_symbolic.hpp"
 
 
 /**
@@ -23,11 +28,12 @@
  * @param num_vertices The number of vertices in the graphs.
  * @param zero The zero value of type T.
  * @param unit The unit value of type T.
+ * @param num_threads The number of threads to split the partitions over.
  * @return The number of isomorphism classes of graphs.
  */
 template<typename T>
-T calc_num_iso_classes_of_graphs(const uint32_t num_vertices, const T zero, const T unit) {
-    T ret = zero;
+T calc_num_iso_classes_of_graphs(const uint32_t num_vertices, const T zero, const T unit, const uint32_t num_threads = 1) {
+    auto partial_sums = std::vector<T>(std::max(num_threads, 1u), zero);
     auto factorial_generator = FactorialGenerator<T>(num_vertices, unit);
     auto lookup = std::vector<T>(num_vertices*num_vertices+1, zero);
     lookup[0] = unit;
@@ -35,7 +41,7 @@ T calc_num_iso_classes_of_graphs(const uint32_t num_vertices, const T zero, cons
     for (uint32_t ind = 1; ind < lookup.size(); ind++) {
         lookup[ind] = TWO*lookup[ind-1];
     }
-    std::function<void(std::vector<PartitionCount>&)> callback = [&ret, &factorial_generator, unit, &lookup](std::vector<PartitionCount>& partition){
+    std::function<void(std::vector<PartitionCount>&, const uint32_t)> callback = [&partial_sums, &factorial_generator, unit, &lookup](std::vector<PartitionCount>& partition, const uint32_t thread_index){
         auto conjugacy_class_size = sym_group_conjugacy_class_size<T>(partition, unit, factorial_generator);
         auto num_cycles = 0;
         auto total_num_cycles = 0;
@@ -67,10 +73,14 @@ T calc_num_iso_classes_of_graphs(const uint32_t num_vertices, const T zero, cons
 
 
         auto loc_contrib = conjugacy_class_size*lookup.at(total_num_cycles);
-        ret = ret+loc_contrib;
+        partial_sums[thread_index] = partial_sums[thread_index]+loc_contrib;
     };
 
-    iterate_partitions(num_vertices, callback);
+    iterate_partitions_parallel(num_vertices, partial_sums.size(), callback);
+    T ret = zero;
+    for (auto& partial_sum : partial_sums) {
+        ret = ret+partial_sum;
+    }
     ret = factorial_generator.get_inv_factorial(num_vertices)*ret;
 
     return ret;
@@ -85,15 +95,15 @@ T calc_num_iso_classes_of_graphs(const uint32_t num_vertices, const T zero, cons
  * @param limit The limit parameter that determines the number of graphs to consider.
  * @param zero The zero value of type T.
  * @param unit The unit value of type T.
+ * @param num_threads The number of threads to split the partitions over.
  * @return Generating function for the isomorphism classes of graphs.
  */
 template<typename T>
-FormalPowerSeries<T> get_iso_classes_of_graphs_gf(uint32_t limit, const T zero, const T unit) {
+FormalPowerSeries<T> get_iso_classes_of_graphs_gf(uint32_t limit, const T zero, const T unit, const uint32_t num_threads = 1) {
     auto ret = FormalPowerSeries<T>::get_atom(zero, 0, limit+1);
 
     for (uint32_t ind = 0; ind <= limit; ind++) {
-        std::cout << ind << std::endl;
-        ret[ind] = calc_num_iso_classes_of_graphs(ind, zero, unit);
+        ret[ind] = calc_num_iso_classes_of_graphs(ind, zero, unit, num_threads);
     }
 
     return ret;
@@ -109,11 +119,12 @@ FormalPowerSeries<T> get_iso_classes_of_graphs_gf(uint32_t limit, const T zero,
  * @param limit The limit parameter that determines the number of graphs to consider.
  * @param zero The zero value of type T.
  * @param unit The unit value of type T.
+ * @param num_threads The number of threads to split the partitions over.
  * @return Generating function for the isomorphism classes of connected graphs.
  */
 template<typename T>
-FormalPowerSeries<T> get_iso_classes_of_connected_graphs_gf(uint32_t limit, const T zero, const T unit) {
-    auto ret = unlabelled_inv_mset(get_iso_classes_of_graphs_gf(limit, zero, unit));
+FormalPowerSeries<T> get_iso_classes_of_connected_graphs_gf(uint32_t limit, const T zero, const T unit, const uint32_t num_threads = 1) {
+    auto ret = unlabelled_inv_mset(get_iso_classes_of_graphs_gf(limit, zero, unit, num_threads));
     return ret;
 }
 
@@ -125,29 +136,32 @@ FormalPowerSeries<T> get_iso_classes_of_connected_graphs_gf(uint32_t limit, cons
  * coefficient of z^i is the number of isomorphism classes of graphs with i edges and num_vertices vertices.
  *
  * @tparam T The type of the elements in the generating function.
+ * @param num_vertices the number of vertices of the graphs.
  * @param max_num_edges the maximal number of edges to consider.
  * @param zero The zero value of type T.
  * @param unit The unit value of type T.
- * @return Generating function for the isomorphism classes of connected graphs.
+ * @param num_threads The number of threads to split the partitions over.
+ * @return Generating function for the isomorphism classes of graphs.
  */
 template<typename T>
-FormalPowerSeries<T> get_iso_classes_of_graphs_fixed_num_vertices_gf(uint32_t num_vertices, uint32_t max_num_edges, const T zero, const T unit) {
+FormalPowerSeries<T> get_iso_classes_of_graphs_fixed_num_vertices_gf(uint32_t num_vertices, uint32_t max_num_edges, const T zero, const T unit, const uint32_t num_threads = 1) {
+    UNUSED(zero);
     auto factorial_generator = FactorialGenerator<T>(num_vertices, unit);
-    FormalPowerSeries<T> ret = FormalPowerSeries<T>::get_zero(unit, max_num_edges+1);
+    auto partial_sums = std::vector<FormalPowerSeries<T>>(std::max(num_threads, 1u), FormalPowerSeries<T>::get_zero(unit, max_num_edges+1));
+    auto num_coefficients = max_num_edges+1;
 
     auto lookup = std::vector<FormalPowerSeries<T>>();
 
-    auto core = FormalPowerSeries<T>::get_atom(unit, 0, ret.num_coefficients())+FormalPowerSeries<T>::get_atom(unit, 1, ret.num_coefficients());
+    auto core = FormalPowerSeries<T>::get_atom(unit, 0, num_coefficients)+FormalPowerSeries<T>::get_atom(unit, 1, num_coefficients);
 
     for (uint32_t exponent = 0; exponent < num_vertices*num_vertices; exponent++) {
         lookup.push_back(core.pow(exponent));
     }
 
-    std::function<void(std::vector<PartitionCount>&)> callback = [&ret, &factorial_generator, &lookup, unit, num_vertices](std::vector<PartitionCount>& partition){
+    std::function<void(std::vector<PartitionCount>&, const uint32_t)> callback = [&partial_sums, &factorial_generator, &lookup, unit, num_vertices, num_coefficients](std::vector<PartitionCount>& partition, const uint32_t thread_index){
         auto conjugacy_class_size = sym_group_conjugacy_class_size<T>(partition, unit, factorial_generator);
         auto num_cycles = 0;
-        auto base = FormalPowerSeries<T>::get_atom(unit, 0, ret.num_coefficients())+FormalPowerSeries<T>::get_atom(unit, 1, ret.num_coefficients());
-        auto cycle_counter = std::vector<uint32_t>(num_vertices*num_vertices, 0);
+        auto cycle_counter = std::vector<uint32_t>(num_vertices*num_vertices+1, 0);
         for (uint32_t ind = 0; ind < partition.size(); ind++) {
             auto size           = partition[ind].num;
             auto num_occurences = partition[ind].count;
@@ -177,66 +191,71 @@ FormalPowerSeries<T> get_iso_classes_of_graphs_fixed_num_vertices_gf(uint32_t nu
                 cycle_counter[orbit_size] += num_cycles;
             }
         }
-        auto loc_contrib = conjugacy_class_size*FormalPowerSeries<T>::get_atom(unit, 0, ret.num_coefficients());
+        auto loc_contrib = conjugacy_class_size*FormalPowerSeries<T>::get_atom(unit, 0, num_coefficients);
 
         for (uint32_t cycle_size = 0; cycle_size < cycle_counter.size(); cycle_size++) {
             num_cycles = cycle_counter[cycle_size];
             if (num_cycles > 0) {
                 auto term = lookup.at(num_cycles);
-                term.resize(ret.num_coefficients());
+                term.resize(num_coefficients);
                 term = term.substitute_exponent(cycle_size);
                 loc_contrib = loc_contrib*term;
             }
         }
 
-        ret = ret+loc_contrib;
+        partial_sums[thread_index] = partial_sums[thread_index]+loc_contrib;
     };
 
-    iterate_partitions(num_vertices, callback);
+    iterate_partitions_parallel(num_vertices, partial_sums.size(), callback);
+    auto ret = FormalPowerSeries<T>::get_zero(unit, num_coefficients);
+    for (auto& partial_sum : partial_sums) {
+        ret = ret+partial_sum;
+    }
     return factorial_generator.get_inv_factorial(num_vertices)*ret;
 }
 
 /**
- * @brief calculates the b.g.f of the number of iso classes of graphs by number of edges and number of vertices.
+ * @brief calculates the b.g.f of the number of iso classes of connected graphs by number of edges and number of vertices.
  *
  * Get the generating functions for the iso classes of connected graphs:
- * coefficient of z^i w^k is the number of isomorphism classes of graphs with i edges and k vertices.
+ * coefficient of z^i w^k is the number of isomorphism classes of connected graphs with i edges and k vertices.
+ *
+ * The inverse Euler transform is done on the Kronecker substitution w^k z^i -> x^(k*(E+1)+i) with E the maximal
+ * number of edges. Graphs on k vertices have at most k(k-1)/2 edges, which is superadditive in k, so the
+ * substitution commutes with all products involved and a single univariate INVMSET suffices.
  *
  * @tparam T The type of the elements in the generating function.
  * @param max_num_vertices the maximal number of vertices to consider.
  * @param zero The zero value of type T.
  * @param unit The unit value of type T.
+ * @param num_threads The number of threads to split the partitions over.
  * @return Bivariate generating function for the isomorphism classes of connected graphs. The inner variable is the number of edges, the outer
  * the number of vertices.
  */
 template<typename T>
 FormalPowerSeries<FormalPowerSeries<T>>
-get_connected_graph_iso_types_by_edge_number(const uint32_t max_num_vertices, const T zero, const T unit) {
-    auto coeffs = std::vector<FormalPowerSeries<T>>();
+get_connected_graph_iso_types_by_edge_number(const uint32_t max_num_vertices, const T zero, const T unit, const uint32_t num_threads = 1) {
     uint32_t max_num_edges = (max_num_vertices*(max_num_vertices-1))/2;
+    uint32_t stride = max_num_edges+1;
+    auto packed = FormalPowerSeries<T>::get_zero(unit, (max_num_vertices+1)*stride);
+
     for (uint32_t num_vertices = 0; num_vertices <= max_num_vertices; num_vertices++) {
-        auto gf = get_iso_classes_of_graphs_fixed_num_vertices_gf(num_vertices, (num_vertices*(num_vertices-1))/2, zero, unit);
-        gf.resize(max_num_edges+1);
-        coeffs.push_back(gf);
-    }
-    auto bgf = FormalPowerSeries<FormalPowerSeries<T>>(std::move(coeffs));
-    auto moebius = calculate_moebius(max_num_vertices);
-    auto ret = FormalPowerSeries<FormalPowerSeries<T>>::get_zero(bgf[max_num_vertices], bgf.num_coefficients());
-    auto funit = FormalPowerSeries<T>::get_atom(unit, 0, max_num_edges+1);
-    for (uint32_t ind = 1; ind <= max_num_vertices; ind++) {
-        auto coeff = (moebius[ind]*unit)/(ind*unit);
-        auto log_arg = bgf;
-
-        for (uint32_t cnt = 0; cnt < log_arg.num_coefficients(); cnt++) {
-            log_arg[cnt] = log_arg[cnt].substitute_exponent(ind);
+        auto gf = get_iso_classes_of_graphs_fixed_num_vertices_gf(num_vertices, (num_vertices*(num_vertices-1))/2, zero, unit, num_threads);
+        for (uint32_t num_edges = 0; num_edges < gf.num_coefficients(); num_edges++) {
+            packed[num_vertices*stride+num_edges] = gf[num_edges];
         }
-
-        log_arg = log_arg.substitute_exponent(ind);
-        auto res = log(log_arg);
-        ret = ret+coeff*funit*res;
     }
 
-    return ret;
+    auto connected = unlabelled_inv_mset(packed);
+    auto coeffs = std::vector<FormalPowerSeries<T>>();
+    for (uint32_t num_vertices = 0; num_vertices <= max_num_vertices; num_vertices++) {
+        auto edge_coeffs = std::vector<T>();
+        for (uint32_t num_edges = 0; num_edges < stride; num_edges++) {
+            edge_coeffs.push_back(connected[num_vertices*stride+num_edges]);
+        }
+        coeffs.push_back(FormalPowerSeries<T>(std::move(edge_coeffs)));
+    }
+    return FormalPowerSeries<FormalPowerSeries<T>>(std::move(coeffs));
 }
 
 /**
@@ -244,6 +263,9 @@ get_connected_graph_iso_types_by_edge_number(const uint32_t max_num_vertices, co
  *
  * Get the generating functions for the iso classes of rooted trees:
  * coefficient of z^i is the number of isomorphism classes of rooted trees on i vertices.
+ * Solves T = z*exp(sum_k T(z^k)/k) by Newton iteration. When going from precision m to 2m,
+ * the terms with k >= 2 only depend on the first m coefficients of T and are therefore already exact,
+ * so every step is a single Newton step for T = z*exp(A)*exp(T) with A fixed.
  *
  * @tparam T The type of the elements in the generating function.
  * @param size the maximal size of the trees to consider.
@@ -253,24 +275,20 @@ get_connected_graph_iso_types_by_edge_number(const uint32_t max_num_vertices, co
  */
 template<typename T>
 FormalPowerSeries<T> get_rooted_trees_gf(const uint32_t size, const T zero, const T unit) {
-    auto ret = FormalPowerSeries<T>::get_atom(zero, 0, size+1);
-    ret[1] = unit;
-    auto f = std::vector<T>(size+1, zero);
-    for (uint32_t ind = 1; ind <= size; ind++) {
-        f[ind] = unit/ind;
-    }
-    for (uint32_t n = 2; n <= size; n++) {
-        T res = zero;
+    auto ret = FormalPowerSeries<T>::get_zero(zero, 1);
+    uint32_t precision = 1;
 
-        for (uint32_t k = 0; k <= n-2; k++) {
-            res = res + (k+1)*f[k+1]*ret[n-k-1];
-        }
+    while (precision < size+1) {
+        precision = std::min(2*precision, size+1);
+        ret.resize(precision);
 
-        res = res/(n-1);
-        ret[n] = res;
-        for (uint32_t k = 1; k <= size/n; k++) {
-            f[k*n] = f[k*n]+res/k;
-        }
+        auto weights = std::vector<int32_t>(precision, 1);
+        weights[1] = 0;
+        auto polya_terms = weighted_exponent_sum(ret, weights);
+
+        auto shifted_exp = exp(polya_terms+ret) << 1;
+        shifted_exp.resize(precision);
+        ret = ret-(ret-shifted_exp)/(unit-shifted_exp);
     }
 
     return ret;
@@ -294,3 +312,21 @@ FormalPowerSeries<T> get_trees_gf(const uint32_t size, const T zero, const T uni
     auto ret = rooted-(rooted*rooted-rooted.substitute_exponent(2))/2;
     return ret;
 }
+
+/**
+ * @brief Returns the generating function for forests up to the given size.
+ *
+ * A forest is a multiset of unrooted trees, so this is MSET applied to the trees generating function.
+ *
+ * @tparam T The type of the coefficients of the power series.
+ * @param size the size limit up to which to generate.
+ * @param zero The additive identity of type `T`.
+ * @param unit The multiplicative identity of type `T`.
+ * @return The generating function for forests of the given size.
+ */
+template<typename T>
+FormalPowerSeries<T> get_forests_gf(const uint32_t size, const T zero, const T unit) {
+    auto trees = get_trees_gf(size, zero, unit);
+    auto weights = std::vector<int32_t>(size+1, 1);
+    return exp(weighted_exponent_sum(trees, weights));
+}
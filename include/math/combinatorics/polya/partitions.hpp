@@ -85,6 +85,22 @@ template<typename T> T sym_group_conjugacy_class_size(const std::vector<Partitio
  */
 void iterate_partitions(const uint32_t size, std::function<void(std::vector<PartitionCount>&)> callback);
 
+/**
+ * @brief Iterates over partitions of a given size on several threads.
+ *
+ * The partitions are split into independent tasks by their prefix, i.e. their largest part together with its multiplicity.
+ * The tasks are handed out to num_threads worker threads; the callback receives the index of the calling thread
+ * so that callers can accumulate into per-thread storage without locking. Exceptions thrown by the callback are rethrown
+ * on the calling thread after all workers have finished.
+ *
+ * @param size The size of the partitions to be generated.
+ * @param num_threads The number of worker threads; values smaller than 2 iterate on the calling thread.
+ * @param callback The callback function to be called for each partition and the index of the thread calling it.
+ */
+void iterate_partitions_parallel(const uint32_t size,
+                                 const uint32_t num_threads,
+                                 std::function<void(std::vector<PartitionCount>&, const uint32_t)> callback);
+
 /**
  * @brief Calculates the sign of a partition.
  *
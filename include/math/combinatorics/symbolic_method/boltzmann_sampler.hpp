@@ -0,0 +1,143 @@
+/**
+ * @file boltzmann_sampler.hpp
+ * @brief Boltzmann samplers for specifications built from the symbolic method operators.
+ *
+ * A specification is a string like "Z*MSET(T)" (rooted trees) or "LSET(LSET(Z, >=1))" (set partitions), made of
+ * Z (atom), 1 (empty object), T (reference to the whole specification), + (disjoint union), * (product) and the
+ * operators SEQ, MSET, CYC (unlabelled) resp. SEQ, LSET, LCYC (labelled). SEQ, LSET and LCYC accept a subset
+ * restriction for the number of components as second argument, in the same syntax as the script operators.
+ */
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/subset_parser.hpp"
+
+enum class BoltzmannNodeType {
+    ATOM,
+    EPSILON,
+    RECURSION,
+    UNION,
+    PRODUCT,
+    SEQ,
+    MSET,
+    CYC,
+    LSET,
+    LCYC,
+};
+
+/**
+ * @brief Node of a parsed specification.
+ */
+struct BoltzmannSpecNode {
+    BoltzmannNodeType type;
+    std::vector<uint32_t> children; /**< Indices of the child nodes. */
+    Subset subset; /**< Allowed numbers of components; the complete subset if unrestricted. */
+    bool restricted;
+    uint32_t min_size;
+
+    BoltzmannSpecNode(BoltzmannNodeType type, const Subset& subset, bool restricted):
+        type(type), subset(subset), restricted(restricted), min_size(0) {}
+};
+
+/**
+ * @brief An object drawn by a Boltzmann sampler.
+ *
+ * Stored as a tree in a flat array: atoms are the nodes with a non-zero label, every other node is the list
+ * of its components. Labels are 1..size; for unlabelled specifications they carry no meaning.
+ */
+struct BoltzmannObject {
+    struct Node {
+        uint32_t label;
+        std::vector<uint32_t> children;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t size;
+
+    /**
+     * @brief Index of the sampled object; node 0 is an auxiliary list holding it.
+     */
+    uint32_t root() const {
+        return nodes[0].children[0];
+    }
+};
+
+/**
+ * @brief Boltzmann sampler with rejection for a target size window.
+ *
+ * The generating function values are evaluated numerically from the specification, truncated consistently at
+ * max_size: every count that only matters for objects larger than max_size is dropped, both in the values and in
+ * the sampling. Conditioned on the size, the drawn objects are hence exactly uniform. The parameter x is tuned such
+ * that the expected size is the middle of the window, and sampling is aborted as soon as an object exceeds
+ * max_size, so for the usual (e.g. tree-like or sequence-like) classes a window of relative width epsilon
+ * costs expected linear time.
+ */
+class BoltzmannSampler {
+ public:
+    /**
+     * @brief Parses the specification and tunes the Boltzmann parameter.
+     *
+     * @param specification The specification string.
+     * @param labelled Whether the specification is labelled (LSET, LCYC) or unlabelled (MSET, CYC).
+     * @param min_size Smallest accepted size.
+     * @param max_size Largest accepted size.
+     */
+    BoltzmannSampler(const std::string& specification, const bool labelled, const uint32_t min_size, const uint32_t max_size);
+
+    /**
+     * @brief Draws objects until one has a size in the target window.
+     *
+     * @param rng The random number generator.
+     * @param max_attempts Number of attempts after which sampling gives up.
+     * @return The sampled object; for labelled specifications with uniformly random labels.
+     */
+    BoltzmannObject sample(std::mt19937_64& rng, const uint64_t max_attempts = 1000000);
+
+    /**
+     * @brief The tuned Boltzmann parameter x.
+     */
+    double get_parameter() const {
+        return parameter;
+    }
+
+ private:
+    struct Task {
+        uint32_t node;
+        uint32_t level;
+        uint32_t parent;
+        uint32_t block_size;
+        uint32_t copies;  // > 0 marks a replication task
+    };
+
+    std::vector<BoltzmannSpecNode> nodes;
+    uint32_t root;
+    bool labelled;
+    uint32_t min_size;
+    uint32_t max_size;
+    double parameter;
+
+    std::vector<std::vector<double>> values;  // values[node][level] is the log of the value of the node at x^level, NaN if not yet computed
+    std::vector<double> recursion_values;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<double>> cumulative_weights;
+    std::vector<int32_t> phi;
+
+    uint32_t parse(const std::string& spec, size_t& pos);
+    uint32_t parse_product(const std::string& spec, size_t& pos);
+    uint32_t parse_factor(const std::string& spec, size_t& pos);
+    void calculate_min_sizes();
+
+    void set_parameter(const double x);
+    double evaluate(const uint32_t node, const uint32_t level, const double* recursion_value);
+    double solve_recursion(const uint32_t level);
+    std::vector<double> component_weights(const uint32_t node, const uint32_t level, const double* recursion_value);
+    const std::vector<double>& get_weights(const uint32_t node, const uint32_t level);
+    double expected_size(const double x);
+    void tune();
+
+    bool sample_once(std::mt19937_64& rng, BoltzmannObject& ret);
+    uint32_t copy_subtree(BoltzmannObject& obj, const uint32_t source);
+};
@@ -7,18 +7,71 @@
 #pragma once
 #include <stdint.h>
 #include <set>
+#include <algorithm>
 #include "types/power_series.hpp"
+#include "common/subset_parser.hpp"
 
 template <typename T> FormalPowerSeries<T> labelled_set_complete(FormalPowerSeries<T> a) {
     auto exp = FormalPowerSeries<T>::get_exp(a.num_coefficients(), RingCompanionHelper<T>::get_unit(a[0]));
     return exp.substitute(a);
 }
 
+/**
+ * @brief Calculates sum(min <= k <= max) a^k/k!, i.e. the difference of two truncated exponentials of a.
+ *
+ * Uses that T_m = sum(k >= m) a^k/k! satisfies T_m' = a'*(T_m+a^(m-1)/(m-1)!), hence
+ * T_m = exp(a)*integral(exp(-a)*a'*a^(m-1)/(m-1)!). This needs a constant number of series operations
+ * independent of the range.
+ *
+ * @param a The power series a; needs a zero constant term.
+ * @param min The smallest exponent.
+ * @param max The largest exponent (inclusive), SUBSET_RANGE_UNBOUNDED for no upper bound.
+ * @return The partial exponential series.
+ */
+template <typename T> FormalPowerSeries<T> labelled_set_range(const FormalPowerSeries<T>& a, const uint32_t min, const uint32_t max) {
+    auto unit = RingCompanionHelper<T>::get_unit(a[0]);
+    auto size = a.num_coefficients();
+    if (min >= size || max < min) {
+        return FormalPowerSeries<T>::get_zero(unit, size);
+    }
+
+    auto has_upper_bound = max != SUBSET_RANGE_UNBOUNDED && max+1 < size;
+    auto exp_a = labelled_set_complete(a);
+    if (min == 0 && !has_upper_bound) {
+        return exp_a;
+    }
+
+    auto integrand = FormalPowerSeries<T>::get_zero(unit, size);
+    auto invfactorial = unit;
+    uint32_t upper_index = has_upper_bound ? max+1 : 0;
+    for (uint32_t ind = 0; ind < std::max(min, upper_index); ind++) {
+        if (ind > 0) {
+            invfactorial = invfactorial/ind;
+        }
+        if (ind+1 == min) {
+            integrand = integrand+invfactorial*a.pow(static_cast<int32_t>(ind));
+        }
+        if (has_upper_bound && ind == max) {
+            integrand = integrand-invfactorial*a.pow(static_cast<int32_t>(ind));
+        }
+    }
+
+    auto ret = exp_a*((a.derivative()*integrand)/exp_a).integral();
+    if (min == 0) {
+        ret = ret+exp_a;
+    }
+    return ret;
+}
+
 template <typename T> FormalPowerSeries<T> labelled_set(FormalPowerSeries<T> a, const Subset& indices) {
     auto unit = RingCompanionHelper<T>::get_unit(a[0]);
     auto ret = FormalPowerSeries<T>::get_zero(unit, a.num_coefficients());
     auto sign = unit;
 
+    if (indices.is_range && a[0] == RingCompanionHelper<T>::get_zero(unit)) {
+        return labelled_set_range(a, indices.range_min, indices.range_max);
+    }
+
     if (indices.negate) {
         sign = -sign;
         ret = labelled_set_complete(a);
@@ -55,11 +108,40 @@ template <typename T> FormalPowerSeries<T> labelled_cyc_complete(FormalPowerSeri
     return log(log_input);
 }
 
+/**
+ * @brief Calculates sum(min <= k <= max, k > 0) a^k/k, i.e. log(1/(1-a)) minus a polynomial in a.
+ *
+ * Uses that sum(k >= m) a^k/k = integral(a'*a^(m-1)/(1-a)) for m > 0.
+ *
+ * @param a The power series a; needs a zero constant term.
+ * @param min The smallest exponent.
+ * @param max The largest exponent (inclusive), SUBSET_RANGE_UNBOUNDED for no upper bound.
+ * @return The partial logarithmic series.
+ */
+template <typename T> FormalPowerSeries<T> labelled_cyc_range(const FormalPowerSeries<T>& a, uint32_t min, const uint32_t max) {
+    auto unit = RingCompanionHelper<T>::get_unit(a[0]);
+    auto size = a.num_coefficients();
+    min = std::max(min, 1u);
+    if (min >= size || max < min) {
+        return FormalPowerSeries<T>::get_zero(unit, size);
+    }
+
+    auto numerator = a.pow(static_cast<int32_t>(min-1));
+    if (max != SUBSET_RANGE_UNBOUNDED && max+1 < size) {
+        numerator = numerator-a.pow(static_cast<int32_t>(max));
+    }
+    return ((a.derivative()*numerator)/(unit-a)).integral();
+}
+
 template <typename T> FormalPowerSeries<T> labelled_cyc(FormalPowerSeries<T> a, const Subset& indices) {
     auto unit = RingCompanionHelper<T>::get_unit(a[0]);
     auto ret = FormalPowerSeries<T>::get_zero(unit, a.num_coefficients());
     auto sign = unit;
 
+    if (indices.is_range && a[0] == RingCompanionHelper<T>::get_zero(unit)) {
+        return labelled_cyc_range(a, indices.range_min, indices.range_max);
+    }
+
     if (indices.negate) {
         sign = -sign;
         ret = labelled_cyc_complete(a);
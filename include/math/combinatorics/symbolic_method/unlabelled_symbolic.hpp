@@ -8,17 +8,44 @@
 #pragma once
 #include <stdint.h>
 #include <set>
+#include <vector>
 #include "types/power_series.hpp"
 #include "math/combinatorics/polya/cycle_index.hpp"
 #include "common/subset_parser.hpp"
 #include "math/number_theory/euler_phi.hpp"
 #include "math/number_theory/moebius.hpp"
 
+/**
+ * @brief Calculates sum(min <= k <= max) a^k as the geometric quotient (a^min-a^(max+1))/(1-a).
+ *
+ * @param a The power series a; needs a zero constant term.
+ * @param min The smallest exponent.
+ * @param max The largest exponent (inclusive), SUBSET_RANGE_UNBOUNDED for no upper bound.
+ * @return The partial geometric series.
+ */
+template <typename T> FormalPowerSeries<T> unlabelled_sequence_range(const FormalPowerSeries<T>& a, const uint32_t min, const uint32_t max) {
+    auto unit = RingCompanionHelper<T>::get_unit(a[0]);
+    auto size = a.num_coefficients();
+    if (min >= size || max < min) {
+        return FormalPowerSeries<T>::get_zero(unit, size);
+    }
+
+    auto numerator = a.pow(static_cast<int32_t>(min));
+    if (max != SUBSET_RANGE_UNBOUNDED && max+1 < size) {
+        numerator = numerator-a.pow(static_cast<int32_t>(max+1));
+    }
+    return numerator/(unit-a);
+}
+
 template <typename T> FormalPowerSeries<T> unlabelled_sequence(FormalPowerSeries<T> a, const Subset& indices) {
     auto unit = RingCompanionHelper<T>::get_unit(a[0]);
     auto ret = FormalPowerSeries<T>::get_zero(unit, a.num_coefficients());
     auto sign = unit;
 
+    if (indices.is_range && a[0] == RingCompanionHelper<T>::get_zero(unit)) {
+        return unlabelled_sequence_range(a, indices.range_min, indices.range_max);
+    }
+
     if (indices.negate) {
         sign = -sign;
         ret = unit/(unit-a);
@@ -79,18 +106,37 @@ template <typename T> FormalPowerSeries<T> unlabelled_mset(FormalPowerSeries<T>
     return ret;
 }
 
-template <typename T> FormalPowerSeries<T> unlabelled_inv_mset(FormalPowerSeries<T> a) {
-    auto mu = calculate_moebius(a.num_coefficients()-1);
+/**
+ * @brief Calculates sum(k >= 1) weights[k]/k*a(z^k) by scattering the coefficients of a onto the indices k*j.
+ *
+ * @param a The power series a.
+ * @param weights The weights; needs at least a.num_coefficients() entries.
+ * @return The weighted sum of the a(z^k).
+ */
+template <typename T> FormalPowerSeries<T> weighted_exponent_sum(const FormalPowerSeries<T>& a, const std::vector<int32_t>& weights) {
     auto unit = RingCompanionHelper<T>::get_unit(a[0]);
+    auto zero = RingCompanionHelper<T>::get_zero(a[0]);
     auto ret = FormalPowerSeries<T>::get_zero(a[0], a.num_coefficients());
 
-    for (uint32_t k = 1; k < a.num_coefficients(); k++)  {
-        ret = ret + (mu[k]*unit)/(k*unit)*log(a.substitute_exponent(k));
+    for (uint32_t k = 1; k < a.num_coefficients(); k++) {
+        if (weights[k] == 0) {
+            continue;
+        }
+        auto factor = (weights[k]*unit)/(k*unit);
+        for (uint32_t j = 1; j*k < a.num_coefficients(); j++) {
+            if (a[j] != zero) {
+                ret[j*k] = ret[j*k]+factor*a[j];
+            }
+        }
     }
 
     return ret;
 }
 
+template <typename T> FormalPowerSeries<T> unlabelled_inv_mset(FormalPowerSeries<T> a) {
+    auto mu = calculate_moebius(a.num_coefficients()-1);
+    return weighted_exponent_sum(log(a), mu);
+}
 
 template <typename T> FormalPowerSeries<T> unlabelled_pset_single(FormalPowerSeries<T> a, const uint32_t num_elements) {
     return pset_cycle_index(num_elements, a, RingCompanionHelper<T>::get_unit(a[0]));
@@ -147,14 +193,7 @@ template <typename T> FormalPowerSeries<T> unlabelled_cyc_single(FormalPowerSeri
 template <typename T> FormalPowerSeries<T> unlabelled_cyc_complete(FormalPowerSeries<T> a) {
     auto phis = calculate_euler_phi(a.num_coefficients()-1);
     auto unit = RingCompanionHelper<T>::get_unit(a[0]);
-    auto ret = FormalPowerSeries<T>::get_zero(a[0], a.num_coefficients());
-    auto expansion_point = unit;
-    FormalPowerSeries<T> log_fps = FormalPowerSeries<T>::get_log(expansion_point, a.num_coefficients(), unit);
-    for (uint32_t k = 1; k < a.num_coefficients(); k++) {
-        auto arg = -log_fps.substitute(-a.substitute_exponent(k));
-        ret = ret + (unit/k)*((phis[k]*unit)*arg);
-    }
-    return ret;
+    return weighted_exponent_sum(log(unit/(unit-a)), phis);
 }
 
 template <typename T> FormalPowerSeries<T> unlabelled_cyc(FormalPowerSeries<T> a, const Subset& indices) {
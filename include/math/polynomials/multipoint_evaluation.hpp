@@ -0,0 +1,130 @@
+/**
+ * @file multipoint_evaluation.hpp
+ * @brief Evaluation of polynomials at many points and interpolation through many points, via subproduct trees.
+ */
+#pragma once
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include "types/polynomial.hpp"
+#include "types/ring_helpers.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+
+#define SUBPRODUCT_TREE_LEAF_SIZE 16  // below this number of points, remainders are evaluated by Horner's scheme
+
+/**
+ * @brief The products prod (z-x_i) over the points of all nodes of a balanced binary tree over x_0, ..., x_{n-1}.
+ *
+ * Node 1 is the root over all points, node k has the children 2k and 2k+1 over the lower and upper half of its points.
+ */
+template<typename T> class SubproductTree {
+ private:
+    std::vector<T> points;
+    std::vector<Polynomial<T>> nodes;
+
+    void build(const uint32_t node, const uint32_t lo, const uint32_t hi) {
+        if (hi-lo == 1) {
+            auto unit = RingCompanionHelper<T>::get_unit(points[lo]);
+            nodes[node] = Polynomial<T>(std::vector<T>({-points[lo], unit}));
+            return;
+        }
+        auto mid = lo+(hi-lo)/2;
+        build(2*node, lo, mid);
+        build(2*node+1, mid, hi);
+        nodes[node] = nodes[2*node]*nodes[2*node+1];
+    }
+
+    void evaluate_node(const Polynomial<T>& remainder, const uint32_t node, const uint32_t lo, const uint32_t hi, std::vector<T>& result) const {
+        if (hi-lo <= SUBPRODUCT_TREE_LEAF_SIZE) {
+            for (uint32_t ind = lo; ind < hi; ind++) {
+                auto value = remainder[remainder.num_coefficients()-1];
+                for (uint32_t j = remainder.num_coefficients()-1; j-- > 0;) {
+                    value = value*points[ind]+remainder[j];
+                }
+                result[ind] = value;
+            }
+            return;
+        }
+        auto mid = lo+(hi-lo)/2;
+        evaluate_node(remainder % nodes[2*node], 2*node, lo, mid, result);
+        evaluate_node(remainder % nodes[2*node+1], 2*node+1, mid, hi, result);
+    }
+
+    Polynomial<T> combine_node(const std::vector<T>& weights, const uint32_t node, const uint32_t lo, const uint32_t hi) const {
+        if (hi-lo == 1) {
+            return Polynomial<T>(std::vector<T>({weights[lo]}));
+        }
+        auto mid = lo+(hi-lo)/2;
+        return combine_node(weights, 2*node, lo, mid)*nodes[2*node+1]+combine_node(weights, 2*node+1, mid, hi)*nodes[2*node];
+    }
+
+ public:
+    /**
+     * @brief Builds the tree in O(M(n) log n) operations.
+     *
+     * @param points The points x_0, ..., x_{n-1}, at least one.
+     */
+    SubproductTree(const std::vector<T>& points): points(points) {
+        if (points.empty()) {
+            throw DatatypeInternalException("Subproduct tree needs at least one point");
+        }
+        auto zero = RingCompanionHelper<T>::get_zero(points[0]);
+        nodes = std::vector<Polynomial<T>>(4*points.size(), Polynomial<T>::get_zero(zero));
+        build(1, 0, points.size());
+    }
+
+    /**
+     * @brief The product prod (z-x_i) over all points.
+     */
+    const Polynomial<T>& get_root() const {
+        return nodes[1];
+    }
+
+    /**
+     * @brief Evaluates f at all points: the value at x_i is f mod (z-x_i), obtained by reducing modulo the nodes from the
+     * root down to the leaves.
+     */
+    std::vector<T> evaluate(const Polynomial<T>& f) const {
+        auto result = std::vector<T>(points.size(), RingCompanionHelper<T>::get_zero(points[0]));
+        auto remainder = f.degree() >= static_cast<int32_t>(points.size()) ? f % nodes[1] : f;
+        evaluate_node(remainder, 1, 0, points.size(), result);
+        return result;
+    }
+
+    /**
+     * @brief The polynomial of degree below n with value y_i at x_i (Lagrange interpolation).
+     *
+     * With M = prod (z-x_i) the interpolant is sum_i y_i/M'(x_i) * M/(z-x_i); the values M'(x_i) are one multipoint
+     * evaluation, and the sum is accumulated up the tree.
+     *
+     * @param values The values y_0, ..., y_{n-1}.
+     * @throws DatatypeInternalException if the points are not distinct.
+     */
+    Polynomial<T> interpolate(const std::vector<T>& values) const {
+        if (values.size() != points.size()) {
+            throw DatatypeInternalException("Number of values does not match the number of interpolation points");
+        }
+
+        auto zero = RingCompanionHelper<T>::get_zero(points[0]);
+        auto& root = nodes[1];
+        auto derivative_coeffs = std::vector<T>();
+        auto factor = zero;
+        for (uint32_t ind = 1; ind < root.num_coefficients(); ind++) {
+            factor = factor+RingCompanionHelper<T>::get_unit(zero);
+            derivative_coeffs.push_back(factor*root[ind]);
+        }
+        auto derivative = Polynomial<T>(std::move(derivative_coeffs));
+
+        auto weights = evaluate(derivative);
+        for (uint32_t ind = 0; ind < weights.size(); ind++) {
+            if (weights[ind] == zero) {
+                throw DatatypeInternalException("Interpolation points have to be distinct");
+            }
+            weights[ind] = values[ind]/weights[ind];
+        }
+
+        auto ret = combine_node(weights, 1, 0, points.size());
+        ret.sanitize();
+        return ret;
+    }
+};
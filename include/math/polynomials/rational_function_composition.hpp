@@ -0,0 +1,68 @@
+/**
+ * @file rational_function_composition.hpp
+ * @brief Composition of rational functions.
+ */
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "types/polynomial.hpp"
+#include "types/rationals.hpp"
+#include "types/ring_helpers.hpp"
+
+/**
+ * @brief Evaluates sum_i p_i a^i b^(deg(p)-i), the homogenization of p, at (a, b) by Horner's scheme.
+ *
+ * @param b_powers The powers b^0, ..., b^deg(p).
+ */
+template<typename T>
+Polynomial<T> evaluate_homogenized(const Polynomial<T>& p, const Polynomial<T>& a, const std::vector<Polynomial<T>>& b_powers) {
+    int32_t degree = p.degree();
+    if (degree < 0) {
+        return Polynomial<T>::get_zero(p[0]);
+    }
+
+    auto ret = Polynomial<T>::get_atom(p[degree], 0);
+    for (int32_t ind = degree-1; ind >= 0; ind--) {
+        ret = ret*a+p[ind]*b_powers[degree-ind];
+    }
+    return ret;
+}
+
+/**
+ * @brief Calculates f(g) for rational functions f = P/Q and g = a/b.
+ *
+ * With d = max(deg(P), deg(Q)), multiplying numerator and denominator of P(a/b)/Q(a/b) by b^d leaves the
+ * homogenizations of P and Q evaluated at (a, b), times powers of b. These are polynomials; only the final
+ * quotient is normalized, so there is a single gcd instead of one per Horner step.
+ *
+ * @throws DatatypeInternalException if the denominator of f vanishes at g.
+ */
+template<typename T>
+RationalNumber<Polynomial<T>> compose_rational_functions(const RationalNumber<Polynomial<T>>& f, const RationalNumber<Polynomial<T>>& g) {
+    auto p = f.get_numerator();
+    auto q = f.get_denominator();
+    auto a = g.get_numerator();
+    auto b = g.get_denominator();
+
+    int32_t deg_p = p.degree();
+    int32_t deg_q = q.degree();
+    int32_t degree = std::max(std::max(deg_p, deg_q), 0);
+
+    auto b_powers = std::vector<Polynomial<T>>({Polynomial<T>::get_unit(b[0])});
+    for (int32_t ind = 1; ind <= degree; ind++) {
+        b_powers.push_back(b_powers.back()*b);
+    }
+
+    auto numerator = evaluate_homogenized(p, a, b_powers);
+    auto denominator = evaluate_homogenized(q, a, b_powers);
+    if (deg_p >= 0) {
+        numerator = numerator*b_powers[degree-deg_p];
+    }
+    denominator = denominator*b_powers[degree-deg_q];
+
+    // scale to constant term 1 of the denominator, which the gcd cancellation preserves
+    auto zero = RingCompanionHelper<T>::get_zero(b[0]);
+    auto scale = denominator[0] != zero ? denominator[0] : denominator[denominator.degree()];
+    return RationalNumber<Polynomial<T>>(numerator/scale, denominator/scale);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file holonomic.hpp
+ * @brief Guessing of P-recursive (holonomic) recurrences and evaluation of single terms of such sequences.
+ *
+ * A recurrence is stored as its coefficient polynomials p_0, ..., p_r, meaning
+ * sum_{i=0}^{r} p_i(n)*a_{n+i} = 0 for all n >= 0.
+ */
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "types/polynomial.hpp"
+#include "types/rationals.hpp"
+#include "types/bigint.hpp"
+#include "types/modLong.hpp"
+
+/**
+ * @brief Guesses a recurrence with polynomial coefficients for the given terms, modulo the modulus of the terms.
+ *
+ * Tries the orders r and coefficient degrees d by increasing number of unknowns (r+1)*(d+1), and accepts the first
+ * ansatz with a non-trivial solution which is overdetermined by a safety margin of equations.
+ *
+ * @param terms The sequence a_0, ..., a_{N-1}.
+ * @return The coefficient polynomials p_0, ..., p_r.
+ * @throws DatatypeInternalException if no recurrence is found.
+ */
+std::vector<Polynomial<ModLong>> guess_recurrence(const std::vector<ModLong>& terms);
+
+/**
+ * @brief Guesses a recurrence with integer polynomial coefficients for the given rational terms.
+ *
+ * The linear algebra is done modulo word sized primes; the solutions are combined by Chinese remaindering and
+ * rational reconstruction until the candidate is verified exactly on all terms.
+ *
+ * @param terms The sequence a_0, ..., a_{N-1}.
+ * @return The coefficient polynomials p_0, ..., p_r, with coprime integer coefficients.
+ * @throws DatatypeInternalException if no recurrence is found.
+ */
+std::vector<Polynomial<RationalNumber<BigInt>>> guess_recurrence(const std::vector<RationalNumber<BigInt>>& terms);
+
+/**
+ * @brief Calculates a_index from a recurrence and its first terms, stepping through the recurrence with r values of memory.
+ *
+ * @param recurrence The coefficient polynomials p_0, ..., p_r.
+ * @param terms The first terms of the sequence, at least r of them; the recurrence is only used beyond them.
+ * @param index The index of the requested term.
+ * @return The term a_index.
+ */
+ModLong recurrence_term(const std::vector<Polynomial<ModLong>>& recurrence, const std::vector<ModLong>& terms, const uint64_t index);
+
+/**
+ * @brief Calculates a_index exactly from a recurrence and its first terms by binary splitting.
+ *
+ * The recurrence is written as v_{n+1} = A(n) v_n / p_r(n) for v_n = (a_n, ..., a_{n+r-1}) with integer matrices A(n);
+ * the matrix product is formed as a balanced product tree, so that the numbers involved grow evenly and fast
+ * multiplication pays off. No intermediate terms are materialized.
+ *
+ * @param recurrence The coefficient polynomials p_0, ..., p_r.
+ * @param terms The first terms of the sequence, at least r of them; the recurrence is only used beyond them.
+ * @param index The index of the requested term.
+ * @return The term a_index.
+ */
+RationalNumber<BigInt> recurrence_term(const std::vector<Polynomial<RationalNumber<BigInt>>>& recurrence,
+                                       const std::vector<RationalNumber<BigInt>>& terms,
+                                       const uint64_t index);
@@ -0,0 +1,54 @@
+/**
+ * @file implicit_equations.hpp
+ * @brief Newton iteration for power series defined by an equation y = F(y).
+ */
+#pragma once
+#include <algorithm>
+#include <string>
+#include "types/power_series.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+
+/**
+ * @brief Solves y = F(y) for a power series y by Newton iteration, starting from the constant term y0.
+ *
+ * Going from precision m to 2m needs F(y) and F(y+z^m); their difference is F'(y)*z^m up to O(z^(2m)),
+ * which is all the Newton step y <- y-(y-F(y))/(1-F'(y)) needs. So F is evaluated twice per doubling.
+ * Terms like y(z^k) for k >= 2 are fine as well, they only contribute O(z^(2m)) to the difference.
+ *
+ * @tparam T The coefficient type.
+ * @tparam F Callable PowerSeries<T> -> PowerSeries<T>, returning at least as many coefficients as its argument has.
+ * @param equation The right hand side F.
+ * @param y0 The constant term of the solution; has to satisfy F(y0)[0] = y0.
+ * @param num_coefficients The number of coefficients to calculate.
+ * @return The solution y.
+ */
+template<typename T, typename F>
+PowerSeries<T> solve_implicit_equation(F equation, const T y0, const uint32_t num_coefficients) {
+    auto unit = RingCompanionHelper<T>::get_unit(y0);
+    auto y = PowerSeries<T>::get_atom(y0, 0, 1);
+
+    if (equation(y)[0] != y0) {
+        throw DatatypeInternalException("Constant term of the solution of the implicit equation is inconsistent");
+    }
+
+    uint32_t precision = 1;
+    while (precision < num_coefficients) {
+        auto next_precision = std::min(2*precision, num_coefficients);
+        y.resize(next_precision);
+
+        auto value = equation(y);
+        auto perturbed = equation(y+PowerSeries<T>::get_atom(unit, precision, next_precision));
+        value.resize(next_precision);
+        perturbed.resize(next_precision);
+
+        auto derivative = (perturbed-value).shift(precision);
+        if (derivative[0] == unit) {
+            throw DatatypeInternalException("Newton iteration failed: 1-F'(y) is not invertible");
+        }
+        auto correction = (y-value).shift(precision)/(unit-derivative);
+        y = y-(correction << precision);
+        precision = next_precision;
+    }
+
+    return y;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file rational_function_coefficients.hpp
+ * @brief Extraction of power series coefficients of rational functions.
+ */
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "types/polynomial.hpp"
+#include "types/bigint.hpp"
+#include "types/ring_helpers.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+
+/**
+ * @brief Calculates the coefficient of z^index in the power series expansion of numerator/denominator (Bostan-Mori).
+ *
+ * Multiplying numerator and denominator by Q(-z) makes the denominator even, Q(z)Q(-z) = V(z^2), and the
+ * coefficient of z^n of U(z)/V(z^2) only depends on the part of U with exponents of the parity of n. Each step hence
+ * halves the index at the cost of two polynomial multiplications of degree d = deg(Q); in total O(M(d) log(index)),
+ * independent of the index' size.
+ *
+ * @tparam T The coefficient type.
+ * @param numerator The numerator P.
+ * @param denominator The denominator Q; after cancelling common factors z, Q(0) has to be invertible.
+ * @param index The index of the coefficient, non-negative.
+ * @return The coefficient [z^index] P/Q.
+ */
+template<typename T>
+T rational_function_coefficient(Polynomial<T> numerator, Polynomial<T> denominator, BigInt index) {
+    auto zero = RingCompanionHelper<T>::get_zero(denominator[0]);
+    if (index < 0) {
+        throw DatatypeInternalException("Negative coefficient index");
+    }
+    if (numerator.degree() < 0) {
+        return zero;
+    }
+
+    uint32_t first_nonzero_idx = 0;
+    while (first_nonzero_idx < denominator.num_coefficients() && denominator[first_nonzero_idx] == zero) {
+        if (first_nonzero_idx < numerator.num_coefficients() && numerator[first_nonzero_idx] != zero) {
+            throw DatatypeInternalException("Power series not invertible");
+        }
+        first_nonzero_idx++;
+    }
+    if (first_nonzero_idx >= denominator.num_coefficients()) {
+        throw DatatypeInternalException("Power series not invertible");
+    }
+
+    if (first_nonzero_idx > 0) {
+        auto shift = [first_nonzero_idx, &zero](const Polynomial<T>& poly) {
+            auto coeffs = std::vector<T>();
+            for (uint32_t ind = first_nonzero_idx; ind < poly.num_coefficients(); ind++) {
+                coeffs.push_back(poly[ind]);
+            }
+            if (coeffs.empty()) {
+                coeffs.push_back(zero);
+            }
+            return Polynomial<T>(std::move(coeffs));
+        };
+        numerator = shift(numerator);
+        denominator = shift(denominator);
+    }
+
+    // normalize to Q(0) = 1, which is preserved by all steps and keeps floating point values in range
+    auto inverse = RingCompanionHelper<T>::get_unit(zero)/denominator[0];
+    numerator = inverse*numerator;
+    denominator = inverse*denominator;
+
+    auto one = BigInt(1);
+    auto two = BigInt(2);
+    while (index > 0) {
+        auto reflected_coeffs = denominator.copy_coefficients();
+        for (uint32_t ind = 1; ind < reflected_coeffs.size(); ind += 2) {
+            reflected_coeffs[ind] = -reflected_coeffs[ind];
+        }
+        auto reflected = Polynomial<T>(std::move(reflected_coeffs));
+
+        auto new_numerator = numerator*reflected;
+        auto new_denominator = denominator*reflected;
+
+        uint32_t parity = index % two == one ? 1 : 0;
+        auto numerator_coeffs = std::vector<T>();
+        for (uint32_t ind = parity; ind < new_numerator.num_coefficients(); ind += 2) {
+            numerator_coeffs.push_back(new_numerator[ind]);
+        }
+        if (numerator_coeffs.empty()) {
+            return zero;
+        }
+        auto denominator_coeffs = std::vector<T>();
+        for (uint32_t ind = 0; ind < new_denominator.num_coefficients(); ind += 2) {
+            denominator_coeffs.push_back(new_denominator[ind]);
+        }
+
+        numerator = Polynomial<T>(std::move(numerator_coeffs));
+        denominator = Polynomial<T>(std::move(denominator_coeffs));
+        index = index/two;
+        if (numerator.degree() < 0) {
+            return zero;
+        }
+    }
+
+    return numerator[0]/denominator[0];
+}
+
+/**
+ * @brief The power series expansion of P/Q with invertible Q(0), computed term by term and kept for later lookups.
+ *
+ * The coefficients satisfy the recurrence Q(0) c_n = p_n - sum_{j >= 1} q_j c_{n-j}, so extending the expansion by one
+ * term costs O(deg(Q)) operations.
+ */
+template<typename T> class RationalFunctionExpansion {
+ private:
+    Polynomial<T> numerator;
+    Polynomial<T> denominator;
+    T inverse;
+    std::vector<T> coefficients;
+
+ public:
+    /**
+     * @throws DatatypeInternalException if Q(0) vanishes.
+     */
+    RationalFunctionExpansion(const Polynomial<T>& numerator, const Polynomial<T>& denominator):
+        numerator(numerator), denominator(denominator), inverse(RingCompanionHelper<T>::get_unit(denominator[0])) {
+        if (denominator[0] == RingCompanionHelper<T>::get_zero(denominator[0])) {
+            throw DatatypeInternalException("Power series not invertible");
+        }
+        inverse = inverse/denominator[0];
+    }
+
+    uint32_t size() const {
+        return coefficients.size();
+    }
+
+    /**
+     * @brief Extends the expansion to at least num_coeffs terms.
+     */
+    void extend(const uint32_t num_coeffs) {
+        auto zero = RingCompanionHelper<T>::get_zero(inverse);
+        coefficients.reserve(num_coeffs);
+        for (uint32_t n = coefficients.size(); n < num_coeffs; n++) {
+            auto current = n < numerator.num_coefficients() ? numerator[n] : zero;
+            auto max_j = std::min<uint32_t>(n, denominator.num_coefficients()-1);
+            for (uint32_t j = 1; j <= max_j; j++) {
+                current = current-denominator[j]*coefficients[n-j];
+            }
+            coefficients.push_back(current*inverse);
+        }
+    }
+
+    const T& operator[](const uint32_t index) const {
+        return coefficients[index];
+    }
+
+    /**
+     * @brief The first num_coeffs coefficients, which have to be computed already.
+     */
+    std::vector<T> get_coefficients(const uint32_t num_coeffs) const {
+        return std::vector<T>(coefficients.begin(), coefficients.begin()+num_coeffs);
+    }
+};
@@ -0,0 +1,119 @@
+/**
+ * @file rational_reconstruction.hpp
+ * @brief Reconstruction of rational functions from truncated power series (Berlekamp-Massey, Pade approximants).
+ */
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "types/power_series.hpp"
+#include "types/polynomial.hpp"
+#include "types/rationals.hpp"
+#include "types/ring_helpers.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+
+/**
+ * @brief Shortest linear recurrence of a sequence over a field (Berlekamp-Massey).
+ *
+ * @tparam T The field type.
+ * @param sequence The sequence s_0, ..., s_{n-1}, non-empty.
+ * @return The connection polynomial C with C(0) = 1 and minimal L such that sum_{j=0}^{L} C_j s_{i-j} = 0 for all L <= i < n,
+ * together with L.
+ */
+template<typename T>
+std::pair<std::vector<T>, uint32_t> berlekamp_massey(const std::vector<T>& sequence) {
+    auto zero = RingCompanionHelper<T>::get_zero(sequence[0]);
+    auto unit = RingCompanionHelper<T>::get_unit(sequence[0]);
+
+    auto connection = std::vector<T>({unit});
+    auto previous = std::vector<T>({unit});
+    uint32_t length = 0;
+    uint32_t shift = 1;
+    auto previous_discrepancy = unit;
+
+    for (uint32_t n = 0; n < sequence.size(); n++) {
+        auto discrepancy = sequence[n];
+        for (uint32_t ind = 1; ind <= length && ind < connection.size(); ind++) {
+            discrepancy = discrepancy+connection[ind]*sequence[n-ind];
+        }
+
+        if (discrepancy == zero) {
+            shift++;
+            continue;
+        }
+
+        auto factor = discrepancy/previous_discrepancy;
+        auto old_connection = connection;
+        if (connection.size() < previous.size()+shift) {
+            connection.resize(previous.size()+shift, zero);
+        }
+        for (uint32_t ind = 0; ind < previous.size(); ind++) {
+            connection[ind+shift] = connection[ind+shift]-factor*previous[ind];
+        }
+
+        if (2*length <= n) {
+            length = n+1-length;
+            previous = old_connection;
+            previous_discrepancy = discrepancy;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+
+    connection.resize(length+1, zero);
+    return std::make_pair(connection, length);
+}
+
+/**
+ * @brief Checks that a reconstructed P/Q is determined by fewer parameters than there are coefficients, and normalizes Q(0) = 1.
+ *
+ * For generic (non-rational) input the approximant uses up all coefficients, so this rejects it.
+ */
+template<typename T>
+RationalNumber<Polynomial<T>> finalize_rational_reconstruction(Polynomial<T> numerator, Polynomial<T> denominator, const uint32_t num_coefficients) {
+    auto zero = RingCompanionHelper<T>::get_zero(denominator[0]);
+    if (denominator[0] == zero) {
+        throw DatatypeInternalException("No rational function with invertible denominator matches the power series");
+    }
+
+    numerator.sanitize();
+    denominator.sanitize();
+    int64_t num_parameters = static_cast<int64_t>(numerator.degree())+1+denominator.degree();
+    if (num_parameters >= num_coefficients) {
+        throw DatatypeInternalException("No rational function found, more coefficients are needed");
+    }
+
+    auto normalization = denominator[0];
+    return RationalNumber<Polynomial<T>>(numerator/normalization, denominator/normalization);
+}
+
+/**
+ * @brief Reconstructs a rational function from its first coefficients, as a Pade approximant.
+ *
+ * The denominator is the connection polynomial C of the shortest linear recurrence (Berlekamp-Massey); since the
+ * recurrence holds from index L on, f*C vanishes there and the numerator is f*C mod z^L. This is the Pade approximant
+ * with denominator degree L, obtained in O(n*L) field operations. Over Q this is far cheaper than the remainder
+ * sequence of the Euclidean algorithm, whose intermediate coefficients grow quickly.
+ *
+ * @tparam T The coefficient field.
+ * @param f The power series.
+ * @return The rational function P/Q with Q(0) = 1.
+ */
+template<typename T>
+RationalNumber<Polynomial<T>> rational_reconstruction(const PowerSeries<T>& f) {
+    uint32_t n = f.num_coefficients();
+    auto zero = RingCompanionHelper<T>::get_zero(f[0]);
+    auto coefficients = f.copy_coefficients();
+    auto [connection, length] = berlekamp_massey(coefficients);
+
+    auto numerator = std::vector<T>(std::max(length, 1u), zero);
+    for (uint32_t ind = 0; ind < length; ind++) {
+        for (uint32_t j = 0; j <= ind && j < connection.size(); j++) {
+            numerator[ind] = numerator[ind]+connection[j]*coefficients[ind-j];
+        }
+    }
+
+    return finalize_rational_reconstruction(Polynomial<T>(std::move(numerator)), Polynomial<T>(std::move(connection)), n);
+}
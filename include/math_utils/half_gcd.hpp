@@ -0,0 +1,218 @@
+/**
+ * @file half_gcd.hpp
+ * @brief Extended gcd of polynomials over a field by the half-gcd algorithm.
+ *
+ * Polynomials are coefficient vectors, lowest degree first, trimmed such that the zero polynomial is the empty vector.
+ */
+
+#ifndef INCLUDE_MATH_UTILS_HALF_GCD_HPP_
+#define INCLUDE_MATH_UTILS_HALF_GCD_HPP_
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include "types/poly_base.hpp"
+#include "math_utils/euclidean_algorithm.hpp"
+
+#define HALF_GCD_BASE_DEGREE 64  // below this degree the half-gcd does single Euclidean steps
+
+template<typename T> using HalfGcdPoly = std::vector<T>;
+
+/**
+ * @brief 2x2 matrix of polynomials, mapping a remainder pair (a, b) to (m00*a+m01*b, m10*a+m11*b).
+ */
+template<typename T> struct HalfGcdMatrix {
+    HalfGcdPoly<T> m00;
+    HalfGcdPoly<T> m01;
+    HalfGcdPoly<T> m10;
+    HalfGcdPoly<T> m11;
+};
+
+template<typename T>
+int32_t half_gcd_degree(const HalfGcdPoly<T>& a) {
+    return static_cast<int32_t>(a.size())-1;
+}
+
+template<typename T>
+void half_gcd_trim(HalfGcdPoly<T>& a, const T& zero) {
+    while (!a.empty() && a.back() == zero) {
+        a.pop_back();
+    }
+}
+
+template<typename T>
+HalfGcdPoly<T> half_gcd_add(const HalfGcdPoly<T>& a, const HalfGcdPoly<T>& b, const T& zero) {
+    auto ret = a.size() >= b.size() ? a : b;
+    auto& other = a.size() >= b.size() ? b : a;
+    for (uint32_t ind = 0; ind < other.size(); ind++) {
+        ret[ind] = ret[ind]+other[ind];
+    }
+    half_gcd_trim(ret, zero);
+    return ret;
+}
+
+template<typename T>
+HalfGcdPoly<T> half_gcd_sub(const HalfGcdPoly<T>& a, const HalfGcdPoly<T>& b, const T& zero) {
+    auto ret = a;
+    if (ret.size() < b.size()) {
+        ret.resize(b.size(), zero);
+    }
+    for (uint32_t ind = 0; ind < b.size(); ind++) {
+        ret[ind] = ret[ind]-b[ind];
+    }
+    half_gcd_trim(ret, zero);
+    return ret;
+}
+
+template<typename T>
+HalfGcdPoly<T> half_gcd_mul(const HalfGcdPoly<T>& a, const HalfGcdPoly<T>& b, const T& zero) {
+    if (a.empty() || b.empty()) {
+        return HalfGcdPoly<T>();
+    }
+    auto ret = multiply_full_raw(a.data(), a.size(), b.data(), b.size());
+    half_gcd_trim(ret, zero);
+    return ret;
+}
+
+/**
+ * @brief Quotient and remainder of a by a non-zero b, by long division.
+ */
+template<typename T>
+std::pair<HalfGcdPoly<T>, HalfGcdPoly<T>> half_gcd_divmod(HalfGcdPoly<T> a, const HalfGcdPoly<T>& b, const T& zero) {
+    if (a.size() < b.size()) {
+        return std::make_pair(HalfGcdPoly<T>(), a);
+    }
+    auto inverse = RingCompanionHelper<T>::get_unit(zero)/b.back();
+    auto quotient = HalfGcdPoly<T>(a.size()-b.size()+1, zero);
+    for (uint32_t shift = quotient.size(); shift-- > 0;) {
+        auto factor = a[shift+b.size()-1]*inverse;
+        quotient[shift] = factor;
+        for (uint32_t ind = 0; ind < b.size(); ind++) {
+            a[shift+ind] = a[shift+ind]-factor*b[ind];
+        }
+    }
+    a.resize(b.size()-1, zero);
+    half_gcd_trim(a, zero);
+    half_gcd_trim(quotient, zero);
+    return std::make_pair(quotient, a);
+}
+
+template<typename T>
+HalfGcdPoly<T> half_gcd_shift_right(const HalfGcdPoly<T>& a, const uint32_t k) {
+    if (a.size() <= k) {
+        return HalfGcdPoly<T>();
+    }
+    return HalfGcdPoly<T>(a.begin()+k, a.end());
+}
+
+template<typename T>
+HalfGcdMatrix<T> half_gcd_identity(const T& zero) {
+    auto unit = HalfGcdPoly<T>({RingCompanionHelper<T>::get_unit(zero)});
+    return HalfGcdMatrix<T>{unit, HalfGcdPoly<T>(), HalfGcdPoly<T>(), unit};
+}
+
+/**
+ * @brief The product lhs*rhs, i.e. first applying rhs and then lhs.
+ */
+template<typename T>
+HalfGcdMatrix<T> half_gcd_compose(const HalfGcdMatrix<T>& lhs, const HalfGcdMatrix<T>& rhs, const T& zero) {
+    return HalfGcdMatrix<T>{
+        half_gcd_add(half_gcd_mul(lhs.m00, rhs.m00, zero), half_gcd_mul(lhs.m01, rhs.m10, zero), zero),
+        half_gcd_add(half_gcd_mul(lhs.m00, rhs.m01, zero), half_gcd_mul(lhs.m01, rhs.m11, zero), zero),
+        half_gcd_add(half_gcd_mul(lhs.m10, rhs.m00, zero), half_gcd_mul(lhs.m11, rhs.m10, zero), zero),
+        half_gcd_add(half_gcd_mul(lhs.m10, rhs.m01, zero), half_gcd_mul(lhs.m11, rhs.m11, zero), zero)};
+}
+
+template<typename T>
+void half_gcd_apply(const HalfGcdMatrix<T>& m, HalfGcdPoly<T>& a, HalfGcdPoly<T>& b, const T& zero) {
+    auto new_a = half_gcd_add(half_gcd_mul(m.m00, a, zero), half_gcd_mul(m.m01, b, zero), zero);
+    auto new_b = half_gcd_add(half_gcd_mul(m.m10, a, zero), half_gcd_mul(m.m11, b, zero), zero);
+    a = std::move(new_a);
+    b = std::move(new_b);
+}
+
+/**
+ * @brief One Euclidean step (a, b) -> (b, a mod b), applied to the remainders and prepended to the matrix.
+ */
+template<typename T>
+void half_gcd_euclidean_step(HalfGcdPoly<T>& a, HalfGcdPoly<T>& b, HalfGcdMatrix<T>& m, const T& zero) {
+    auto [quotient, remainder] = half_gcd_divmod(a, b, zero);
+    a = std::move(b);
+    b = std::move(remainder);
+
+    auto new_m10 = half_gcd_sub(m.m00, half_gcd_mul(quotient, m.m10, zero), zero);
+    auto new_m11 = half_gcd_sub(m.m01, half_gcd_mul(quotient, m.m11, zero), zero);
+    m.m00 = std::move(m.m10);
+    m.m01 = std::move(m.m11);
+    m.m10 = std::move(new_m10);
+    m.m11 = std::move(new_m11);
+}
+
+/**
+ * @brief Matrix of the Euclidean steps on (a, b), deg(a) >= deg(b), until the second remainder has degree below
+ * ceil(deg(a)/2).
+ *
+ * The quotients only depend on the upper halves of a and b, so they are found recursively on those: the first half
+ * of the steps on the top deg(a)/2 coefficients, the second half on the top coefficients of the remainders after
+ * one further step. With fast multiplication of the matrices this takes O(M(n) log n) operations.
+ */
+template<typename T>
+HalfGcdMatrix<T> half_gcd(HalfGcdPoly<T> a, HalfGcdPoly<T> b, const T& zero) {
+    int32_t m = (half_gcd_degree(a)+1)/2;
+    auto ret = half_gcd_identity(zero);
+    if (half_gcd_degree(b) < m) {
+        return ret;
+    }
+
+    if (half_gcd_degree(a) < HALF_GCD_BASE_DEGREE) {
+        while (half_gcd_degree(b) >= m) {
+            half_gcd_euclidean_step(a, b, ret, zero);
+        }
+        return ret;
+    }
+
+    ret = half_gcd(half_gcd_shift_right(a, m), half_gcd_shift_right(b, m), zero);
+    half_gcd_apply(ret, a, b, zero);
+    if (half_gcd_degree(b) < m) {
+        return ret;
+    }
+
+    half_gcd_euclidean_step(a, b, ret, zero);
+    int32_t k = 2*m-half_gcd_degree(a);
+    if (half_gcd_degree(b) < m) {
+        return ret;
+    }
+    auto second = half_gcd(half_gcd_shift_right(a, k), half_gcd_shift_right(b, k), zero);
+    return half_gcd_compose(second, ret, zero);
+}
+
+/**
+ * @brief Gcd g and Bezout cofactors s, t with s*a+t*b = g of two polynomials over a field.
+ *
+ * @tparam T The coefficient field.
+ * @param a The first polynomial, trimmed.
+ * @param b The second polynomial, trimmed.
+ * @param zero The zero of the field.
+ */
+template<typename T>
+EuclideanAlgoResult<HalfGcdPoly<T>> half_gcd_extended_euclidean_algorithm(HalfGcdPoly<T> a, HalfGcdPoly<T> b, const T& zero) {
+    auto transform = half_gcd_identity(zero);
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+        std::swap(transform.m00, transform.m01);
+        std::swap(transform.m10, transform.m11);
+    }
+
+    while (!b.empty()) {
+        if (2*half_gcd_degree(b) > half_gcd_degree(a)) {
+            auto step = half_gcd(a, b, zero);
+            half_gcd_apply(step, a, b, zero);
+            transform = half_gcd_compose(step, transform, zero);
+        } else {
+            half_gcd_euclidean_step(a, b, transform, zero);
+        }
+    }
+    return EuclideanAlgoResult<HalfGcdPoly<T>>(a, transform.m00, transform.m01);
+}
+
+#endif  // INCLUDE_MATH_UTILS_HALF_GCD_HPP_
@@ -0,0 +1,215 @@
+/**
+ * @file modular_polynomial_gcd.hpp
+ * @brief Gcd of integer polynomials via gcds modulo word sized primes (Brown's modular algorithm).
+ *
+ * Polynomials are dense coefficient vectors, lowest degree first, without leading zeros.
+ */
+
+#ifndef INCLUDE_MATH_UTILS_MODULAR_POLYNOMIAL_GCD_HPP_
+#define INCLUDE_MATH_UTILS_MODULAR_POLYNOMIAL_GCD_HPP_
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include "types/bigint.hpp"
+
+/**
+ * @brief Checks whether n is prime by trial division; meant for numbers below 2^31.
+ */
+inline bool is_prime_by_trial_division(const int64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (int64_t d = 2; d*d <= n; d++) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The largest prime below p.
+ */
+inline int64_t previous_prime(int64_t p) {
+    do {
+        p--;
+    } while (!is_prime_by_trial_division(p));
+    return p;
+}
+
+/**
+ * @brief a^(p-2) mod p, the inverse of a modulo the prime p.
+ */
+inline int64_t inverse_mod_prime(int64_t a, const int64_t p) {
+    int64_t ret = 1;
+    for (int64_t exponent = p-2; exponent > 0; exponent /= 2) {
+        if (exponent % 2 == 1) {
+            ret = (ret*a) % p;
+        }
+        a = (a*a) % p;
+    }
+    return ret;
+}
+
+/**
+ * @brief Monic gcd of two polynomials modulo a prime p < 2^31, by the Euclidean algorithm.
+ */
+inline std::vector<int64_t> polynomial_gcd_mod_prime(std::vector<int64_t> a, std::vector<int64_t> b, const int64_t p) {
+    auto trim = [](std::vector<int64_t>& poly) {
+        while (!poly.empty() && poly.back() == 0) {
+            poly.pop_back();
+        }
+    };
+    trim(a);
+    trim(b);
+
+    while (!b.empty()) {
+        auto inverse = inverse_mod_prime(b.back(), p);
+        while (a.size() >= b.size()) {
+            auto factor = (a.back()*inverse) % p;
+            auto shift = a.size()-b.size();
+            for (uint32_t ind = 0; ind < b.size(); ind++) {
+                a[ind+shift] = (a[ind+shift]+(p-factor)*b[ind]) % p;
+            }
+            trim(a);
+        }
+        std::swap(a, b);
+    }
+
+    if (!a.empty()) {
+        auto inverse = inverse_mod_prime(a.back(), p);
+        for (auto& x : a) {
+            x = (x*inverse) % p;
+        }
+    }
+    return a;
+}
+
+/**
+ * @brief Divides an integer polynomial by its content, such that the leading coefficient is positive.
+ */
+inline std::vector<BigInt> primitive_part(std::vector<BigInt> poly) {
+    auto content = BigInt(0);
+    for (auto& x : poly) {
+        auto abs_value = x < 0 ? -x : x;
+        content = gcd(content, abs_value);
+    }
+    if (poly.back() < 0) {
+        content = -content;
+    }
+    for (auto& x : poly) {
+        x = x/content;
+    }
+    return poly;
+}
+
+/**
+ * @brief Checks whether divisor divides poly over Z; for primitive divisors this is the same as over Q (Gauss' lemma).
+ */
+inline bool divides_integer_polynomial(const std::vector<BigInt>& divisor, std::vector<BigInt> poly) {
+    auto zero = BigInt(0);
+    auto leading = divisor.back();
+    while (poly.size() >= divisor.size()) {
+        if (poly.back() % leading != zero) {
+            return false;
+        }
+        auto factor = poly.back()/leading;
+        auto shift = poly.size()-divisor.size();
+        for (uint32_t ind = 0; ind < divisor.size(); ind++) {
+            poly[ind+shift] -= factor*divisor[ind];
+        }
+        while (!poly.empty() && poly.back() == zero) {
+            poly.pop_back();
+        }
+    }
+    return poly.empty();
+}
+
+/**
+ * @brief Primitive gcd of two non-zero integer polynomials, with positive leading coefficient.
+ *
+ * The gcd is computed modulo word sized primes, scaled to the leading coefficient gcd(lc(a), lc(b)) which the true gcd
+ * times some integer has, and combined by Chinese remaindering. Primes for which the gcd has too large degree are
+ * unlucky and dropped. Once the symmetric lift is stable over one more prime, its primitive part is accepted if it
+ * divides both inputs. Unlike the Euclidean algorithm over Q, no intermediate coefficients grow beyond the size of
+ * the result.
+ */
+inline std::vector<BigInt> integer_polynomial_gcd(const std::vector<BigInt>& a, const std::vector<BigInt>& b) {
+    auto prim_a = primitive_part(a);
+    auto prim_b = primitive_part(b);
+    if (prim_a.size() == 1 || prim_b.size() == 1) {
+        return std::vector<BigInt>({BigInt(1)});
+    }
+
+    auto leading_a = prim_a.back();
+    auto leading_b = prim_b.back();
+    auto leading_gcd = gcd(leading_a, leading_b);
+
+    auto reduce = [](const std::vector<BigInt>& poly, const BigInt& p) {
+        auto ret = std::vector<int64_t>();
+        for (auto& x : poly) {
+            ret.push_back((x % p).as_int64());
+        }
+        return ret;
+    };
+
+    auto combined = std::vector<BigInt>();
+    auto modulus = BigInt(1);
+    auto previous_lift = std::vector<BigInt>();
+    int64_t p = 2147483648;  // primes below 2^31 keep all products in int64
+    while (true) {
+        p = previous_prime(p);
+        auto big_p = BigInt(p);
+        if (leading_a % big_p == BigInt(0) || leading_b % big_p == BigInt(0)) {
+            continue;
+        }
+
+        auto image = polynomial_gcd_mod_prime(reduce(prim_a, big_p), reduce(prim_b, big_p), p);
+        if (image.size() == 1) {
+            return std::vector<BigInt>({BigInt(1)});
+        }
+        if (!combined.empty() && image.size() > combined.size()) {
+            continue;
+        }
+
+        auto scale = (leading_gcd % big_p).as_int64();
+        for (auto& x : image) {
+            x = (x*scale) % p;
+        }
+
+        if (combined.empty() || image.size() < combined.size()) {
+            combined.clear();
+            for (auto x : image) {
+                combined.push_back(BigInt(x));
+            }
+            modulus = big_p;
+            previous_lift.clear();
+            continue;
+        }
+
+        // Chinese remaindering: x + m*((y-x)/m mod p)
+        auto inverse = inverse_mod_prime((modulus % big_p).as_int64(), p);
+        for (uint32_t ind = 0; ind < combined.size(); ind++) {
+            auto x_mod_p = (combined[ind] % big_p).as_int64();
+            auto t = (((image[ind]-x_mod_p+p) % p)*inverse) % p;
+            combined[ind] += modulus*BigInt(t);
+        }
+        modulus = modulus*big_p;
+
+        auto half_modulus = modulus/BigInt(2);
+        auto lift = combined;
+        for (auto& x : lift) {
+            if (x > half_modulus) {
+                x = x-modulus;
+            }
+        }
+        lift = primitive_part(lift);
+        if (lift == previous_lift && divides_integer_polynomial(lift, prim_a) && divides_integer_polynomial(lift, prim_b)) {
+            return lift;
+        }
+        previous_lift = lift;
+    }
+}
+
+#endif  // INCLUDE_MATH_UTILS_MODULAR_POLYNOMIAL_GCD_HPP_
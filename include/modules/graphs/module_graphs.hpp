@@ -0,0 +1,4 @@
+#pragma once
+#include "modules/module_registration/module_registration.hpp"
+
+Module create_graphs_module();
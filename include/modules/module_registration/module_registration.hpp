@@ -14,6 +14,7 @@ class ModuleContextInterface {
      virtual ~ModuleContextInterface() = default;
      virtual const ShellParameters& get_shell_parameters() const = 0;
      virtual void handle_print(const std::string& output, bool line_break = true) const  = 0;
+     virtual std::shared_ptr<SymObject> call_custom_function(const std::string& name, const std::vector<std::shared_ptr<SymObject>>& args) = 0;
 };
 
 
@@ -82,6 +83,22 @@ class Module {
         return &it->second;
     }
 
+    const ModuleFunction* find_function(const std::string& func_name) const {
+        auto it = functions.find(func_name);
+        if (it == functions.end()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    const ModuleConstant* find_constant(const std::string& const_name) const {
+        auto it = constants.find(const_name);
+        if (it == constants.end()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
     bool is_module_element(std::queue<std::string>& module_path) const;
 
     void get_all_autocompletable_names(const std::string& parent_path, std::vector<std::string>& names) const {
@@ -111,6 +128,7 @@ class Module {
 
 class ModuleRegister {
       std::map<std::string, Module> modules;
+      const Module* find_parent_module(const std::vector<std::string>& parts) const;
  public:
       void register_module(const std::string& name, const Module& new_module);
       std::shared_ptr<Module> get_module(const std::string& name);
@@ -118,6 +136,23 @@ class ModuleRegister {
           std::vector<std::shared_ptr<SymObjectContainer>>& args,
           const std::shared_ptr<ModuleContextInterface>& context) const;
       std::shared_ptr<SymObjectContainer> get_module_constant(std::queue<std::string>& module_path) const;
+
+      /**
+       * @brief Looks up a module function by its full dotted path, without throwing if it does not exist.
+       *
+       * The elements stay at their addresses as long as the register lives, so they can be bound once instead of
+       * being looked up on every use.
+       *
+       * @return The function, or nullptr if there is none with this path.
+       */
+      const ModuleFunction* find_module_function(const std::string& element_path) const;
+
+      /**
+       * @brief Looks up a module constant by its full dotted path, without throwing if it does not exist.
+       *
+       * @return The constant, or nullptr if there is none with this path.
+       */
+      const ModuleConstant* find_module_constant(const std::string& element_path) const;
       bool is_builtin(const std::string& name) const;
       bool is_module_element(const std::string& element_path) const;
       void get_all_autocompletable_names(std::vector<std::string>& names) const;
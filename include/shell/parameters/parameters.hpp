@@ -23,12 +23,20 @@ class InterpreterContext;
  * @brief Structure representing the parameters for the shell.
  */
 struct ShellParameters {
-    ShellParameters() : powerseries_expansion_size(DEFAULT_POWERSERIES_PRECISION), profile_output(false), lexer_output(false), shunting_yard_output(false) {}
-    ShellParameters(const CmdLineOptions& opts) : powerseries_expansion_size(DEFAULT_POWERSERIES_PRECISION), profile_output(opts.profile_output), lexer_output(opts.lexer_output), shunting_yard_output(opts.shunting_yard_output) {}
+    ShellParameters() : powerseries_expansion_size(DEFAULT_POWERSERIES_PRECISION), profile_output(false), lexer_output(false), shunting_yard_output(false),
+                        constant_folding(true), hoist_loop_invariants(true), inline_functions(true), bytecode_execution(true), profile_file("") {}
+    ShellParameters(const CmdLineOptions& opts) : powerseries_expansion_size(DEFAULT_POWERSERIES_PRECISION), profile_output(opts.profile_output), lexer_output(opts.lexer_output), shunting_yard_output(opts.shunting_yard_output),
+                        constant_folding(true), hoist_loop_invariants(true), inline_functions(true), bytecode_execution(true),
+                        profile_file(opts.profile_file.value_or("")) {}
     uint32_t powerseries_expansion_size; /**< Size of the power series expansion. */
     bool profile_output; /**< Whether to output profiling information after each evaluation. */
     bool lexer_output; /**< Whether to output profiling information for the lexer. */
     bool shunting_yard_output; /**< Whether to output profiling information for the shunting yard algorithm. */
+    bool constant_folding; /**< Whether to evaluate constant subexpressions before execution. */
+    bool hoist_loop_invariants; /**< Whether to evaluate loop-invariant expressions once per loop execution. */
+    bool inline_functions; /**< Whether to inline calls of small non-recursive functions. */
+    bool bytecode_execution; /**< Whether to compile programs to bytecode instead of walking the polish notation. */
+    std::string profile_file; /**< File the sampling profiler writes collapsed stacks to after each evaluation; empty if profiling is off. */
 };
 
 CommandResult handle_setparam_command(std::shared_ptr<InterpreterContext>, const std::vector<std::string>& args, const std::string& command_name);
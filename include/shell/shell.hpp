@@ -23,6 +23,7 @@
 #include "shell/parameters/parameters.hpp"
 #include "shell/command_handling.hpp"
 #include "common/file_location.hpp"
+#include "common/kernel_stats.hpp"
 #include "modules/module_factory.hpp"
 
 class ShellInput {
@@ -355,6 +356,11 @@ class FormulaParser {
         auto now = std::chrono::high_resolution_clock::now();
 
         context->reset_steps();
+        auto profile_file = context->get_shell_parameters().profile_file;
+        auto profiler = context->start_profiler();
+        if (profiler && file_obj->get_name().empty()) {
+            profiler->set_source("", file_obj->read());
+        }
         std::unique_ptr<FormulaParsingResult> ret = nullptr;
         try {
              auto res = parse_formula(context, file_obj);
@@ -369,12 +375,22 @@ class FormulaParser {
             ret = std::make_unique<FormulaUnexpectedExceptionResult>(e);
         }
 
+        if (profiler) {
+            context->stop_profiler();
+            std::ofstream stream(profile_file);
+            profiler->write_collapsed_stacks(stream);
+        }
+
         if (context->get_shell_parameters().profile_output) {
             auto end = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count();
             std::cout << "Parsing and evaluation took " << duration << " ms and " << context->get_steps() << " steps" << std::endl;
             std::cout << "Average time per step: " << (context->get_steps() > 0 ? static_cast<double>(duration) / context->get_steps() : 0) << " ms" << std::endl;
             std::cout << "Average steps per s: " << (duration > 0 ? static_cast<double>(context->get_steps())*1000.0 / duration : 0) << " steps/s" << std::endl;
+            if (profiler) {
+                profiler->write_report(std::cout, PROFILER_REPORT_ENTRIES);
+            }
+            write_kernel_statistics(std::cout);
         }
         return ret;
     }
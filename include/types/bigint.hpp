@@ -503,6 +503,21 @@ class BigInt {
         return ret;
     }
 
+    /**
+     * @brief Whether the value is held as a machine integer, such that as_int64 is exact and does not involve GMP.
+     * @return True if the value is small, false otherwise.
+     */
+    bool is_small_value() const {
+        return is_small;
+    }
+
+    /**
+     * @brief The number of limbs of the value in GMP; 1 for small values.
+     */
+    size_t num_limbs() const {
+        return is_small ? 1 : mpz_size(value);
+    }
+
     int64_t as_int64() const {
         if (is_small) {
             return small_value;
@@ -7,7 +7,9 @@
 #define INCLUDE_TYPES_POLY_BASE_HPP_
 
 #include <algorithm>
+#include <stdexcept>
 #include <vector>
+#include "common/kernel_stats.hpp"
 #include "types/ring_helpers.hpp"
 
 /**
@@ -60,6 +62,7 @@ std::vector<T> multiply_full_raw(const T* a, const uint32_t size_a,
     }
 
     auto size = size_a+size_b-1;
+    auto timer = KernelTimer(POLYNOMIAL_MULTIPLY, std::max(size_a, size_b), size < KARATSUBA_THRESHOLD ? SCHOOLBOOK : KARATSUBA);
     auto zero = RingCompanionHelper<T>::get_zero(a[0]);
     if (size < KARATSUBA_THRESHOLD) {
         std::vector<T> ret = std::vector<T>(size, zero);
@@ -10,12 +10,19 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include "common/kernel_stats.hpp"
 #include "exceptions/datatype_internal_exception.hpp"
 #include "types/poly_base.hpp"
 #include "types/ring_helpers.hpp"
 #include "types/bigint.hpp"
 #include "types/rationals.hpp"
+#include "types/modLong.hpp"
 #include "math_utils/euclidean_algorithm.hpp"
+#include "math_utils/modular_polynomial_gcd.hpp"
+#include "math_utils/half_gcd.hpp"
+#include "types/power_series.hpp"
+
+#define NEWTON_DIVISION_THRESHOLD 2048  // degrees of divisor and quotient from which division uses Newton inversion; measured with Karatsuba over Z/pZ
 
 template<typename T> class Polynomial: public PolyBase<T> {
  public:
@@ -171,22 +178,96 @@ template<typename T> class Polynomial: public PolyBase<T> {
         this->resize(degree+1);
     }
 
+    /**
+     * @brief Long division with remainder, one coefficient of the quotient per step.
+     */
+    static std::pair<Polynomial, Polynomial> schoolbook_division(Polynomial a, const Polynomial& b) {
+        auto zero = RingCompanionHelper<T>::get_zero(a.coefficients[0]);
+        int32_t deg_a = a.degree();
+        int32_t deg_b = b.degree();
+        auto timer = KernelTimer(POLYNOMIAL_DIVIDE, deg_a+1, SCHOOLBOOK);
+        auto quotient = std::vector<T>(deg_a-deg_b+1, zero);
+        for (int32_t ind = deg_a; ind >= deg_b; ind--) {
+            auto c = a.coefficients[ind]/b.coefficients[deg_b];
+            quotient[ind-deg_b] = c;
+            if (c == zero) {
+                continue;
+            }
+            for (int32_t j = 0; j < deg_b; j++) {
+                a.coefficients[ind-deg_b+j] = a.coefficients[ind-deg_b+j]-c*b.coefficients[j];
+            }
+            a.coefficients[ind] = zero;
+        }
+
+        a.resize(std::max(deg_b, 1));
+        a.sanitize();
+        auto q = Polynomial(std::move(quotient));
+        q.sanitize();
+        return std::make_pair(q, a);
+    }
+
+    /**
+     * @brief The first num_coefficients coefficients of the inverse of the reversed polynomial z^deg(b)*b(1/z).
+     */
+    static PowerSeries<T> reversed_inverse(const Polynomial& b, const uint32_t num_coefficients) {
+        auto zero = RingCompanionHelper<T>::get_zero(b.coefficients[0]);
+        int32_t deg_b = b.degree();
+        auto reversed = std::vector<T>(num_coefficients, zero);
+        for (int32_t ind = 0; ind <= deg_b && static_cast<uint32_t>(ind) < num_coefficients; ind++) {
+            reversed[ind] = b.coefficients[deg_b-ind];
+        }
+        return PowerSeries<T>(std::move(reversed)).invert();
+    }
+
+    /**
+     * @brief Division with remainder given the inverse of the reversed divisor to at least deg(a)-deg(b)+1 coefficients.
+     *
+     * The reversed quotient is the reversed dividend times this inverse, modulo z^(deg(a)-deg(b)+1); the remainder
+     * then costs one more multiplication.
+     */
+    static std::pair<Polynomial, Polynomial> newton_division(const Polynomial& a, const Polynomial& b, const PowerSeries<T>& inverse) {
+        auto zero = RingCompanionHelper<T>::get_zero(a.coefficients[0]);
+        int32_t deg_a = a.degree();
+        int32_t deg_b = b.degree();
+        uint32_t size = deg_a-deg_b+1;
+        auto timer = KernelTimer(POLYNOMIAL_DIVIDE, deg_a+1, NEWTON);
+
+        auto reversed = std::vector<T>(size, zero);
+        for (uint32_t ind = 0; ind < size; ind++) {
+            reversed[ind] = a.coefficients[deg_a-ind];
+        }
+        auto inverse_coefficients = inverse.copy_coefficients();
+        auto reversed_quotient = multiply_full_raw(reversed.data(), size, inverse_coefficients.data(), std::min<uint32_t>(size, inverse_coefficients.size()));
+
+        auto quotient = std::vector<T>(size, zero);
+        for (uint32_t ind = 0; ind < size; ind++) {
+            quotient[size-1-ind] = reversed_quotient[ind];
+        }
+        auto q = Polynomial(std::move(quotient));
+        q.sanitize();
+
+        auto r = a-q*b;
+        r.resize(std::max(deg_b, 1));
+        r.sanitize();
+        return std::make_pair(q, r);
+    }
+
     friend std::pair<Polynomial, Polynomial> polynomial_div(Polynomial a, const Polynomial& b) {
         Polynomial<T> zero = Polynomial::get_zero(a.coefficients[0]);
         if (b == zero) {
             throw(DatatypeInternalException("Division by zero"));
         }
-        auto q = zero;
-        auto r = a;
-        while (r != zero && r.degree() >= b.degree()) {
-            auto c = r.coefficients[r.degree()]/b.coefficients[b.degree()];
-            auto t = Polynomial::get_atom(c, r.degree()-b.degree());
-            q = q+t;
-            r = r-t*b;
-            r.sanitize();
+
+        int32_t deg_a = a.degree();
+        int32_t deg_b = b.degree();
+        if (deg_a < deg_b) {
+            return std::make_pair(zero, a);
         }
-        q.sanitize();
-        return std::make_pair(q, r);
+
+        if (deg_b < NEWTON_DIVISION_THRESHOLD || deg_a-deg_b < NEWTON_DIVISION_THRESHOLD) {
+            return schoolbook_division(a, b);
+        }
+        return newton_division(a, b, reversed_inverse(b, deg_a-deg_b+1));
     }
 
     friend Polynomial operator/(Polynomial a, const Polynomial& b) {
@@ -222,17 +303,142 @@ template<typename T> class Polynomial: public PolyBase<T> {
     }
 };
 
+/**
+ * @brief A fixed divisor with the inverse of its reversal precomputed, for repeated division by the same polynomial.
+ *
+ * Each division then costs two multiplications; the inverse is extended when a dividend needs more precision.
+ */
+template<typename T> class PolynomialDivisor {
+ private:
+    Polynomial<T> divisor;
+    PowerSeries<T> inverse;
+
+ public:
+    /**
+     * @brief Precomputes the inverse for dividends of degree up to 2*deg(divisor)-2, e.g. products of two remainders.
+     */
+    PolynomialDivisor(const Polynomial<T>& divisor): divisor(divisor), inverse(PowerSeries<T>::get_zero(divisor[0], 1)) {
+        if (divisor.degree() < 0) {
+            throw DatatypeInternalException("Division by zero");
+        }
+        this->divisor.sanitize();
+        inverse = Polynomial<T>::reversed_inverse(this->divisor, std::max(this->divisor.degree(), 1));
+    }
+
+    std::pair<Polynomial<T>, Polynomial<T>> divide(const Polynomial<T>& a) {
+        int32_t deg_a = a.degree();
+        int32_t deg_b = divisor.degree();
+        if (deg_a < deg_b) {
+            return std::make_pair(Polynomial<T>::get_zero(divisor[0]), a);
+        }
+
+        uint32_t size = deg_a-deg_b+1;
+        if (size > inverse.num_coefficients()) {
+            inverse = Polynomial<T>::reversed_inverse(divisor, std::max<uint32_t>(size, 2*inverse.num_coefficients()));
+        }
+        return Polynomial<T>::newton_division(a, divisor, inverse);
+    }
+
+    Polynomial<T> reduce(const Polynomial<T>& a) {
+        return divide(a).second;
+    }
+};
+
+/**
+ * @brief Extended Euclidean algorithm over Z/pZ by the half-gcd algorithm, which falls back to single Euclidean steps
+ * for small degrees.
+ */
+template<>
+inline EuclideanAlgoResult<Polynomial<ModLong>> extended_euclidean_algorithm(Polynomial<ModLong> a, Polynomial<ModLong> b) {
+    auto zero = RingCompanionHelper<ModLong>::get_zero(a[0]);
+    auto to_vector = [&zero](const Polynomial<ModLong>& poly) {
+        auto ret = poly.copy_coefficients();
+        half_gcd_trim(ret, zero);
+        return ret;
+    };
+    auto to_polynomial = [&zero](HalfGcdPoly<ModLong>& poly) {
+        if (poly.empty()) {
+            poly.push_back(zero);
+        }
+        return Polynomial<ModLong>(std::move(poly));
+    };
+
+    auto res = half_gcd_extended_euclidean_algorithm(to_vector(a), to_vector(b), zero);
+    return EuclideanAlgoResult<Polynomial<ModLong>>(to_polynomial(res.gcd), to_polynomial(res.bezouta), to_polynomial(res.bezoutb));
+}
+
 template<typename T>
 Polynomial<T> gcd(Polynomial<T> a, Polynomial<T> b) {
+    auto timer = KernelTimer(POLYNOMIAL_GCD, std::max(a.num_coefficients(), b.num_coefficients()), EUCLIDEAN);
     auto euclidean_algo_result = extended_euclidean_algorithm(a, b);
     return euclidean_algo_result.gcd;
 }
 
+/**
+ * @brief Normalizes a polynomial gcd over a field to constant term 1, or to a monic polynomial if the constant term vanishes.
+ *
+ * Cancelling such a gcd keeps a denominator with constant term 1 normalized.
+ */
+template<typename T>
+Polynomial<T> normalize_polynomial_gcd(const Polynomial<T>& g) {
+    auto zero = RingCompanionHelper<T>::get_zero(g[0]);
+    if (g[0] != zero) {
+        return g/g[0];
+    }
+    auto degree = g.degree();
+    if (degree < 0) {
+        return g;
+    }
+    return g/g[degree];
+}
+
+/**
+ * @brief Multiplies a polynomial over Q by the lcm of its denominators, yielding the integer coefficients.
+ */
+inline std::vector<BigInt> clear_denominators(const Polynomial<RationalNumber<BigInt>>& poly) {
+    auto common_denominator = BigInt(1);
+    for (uint32_t ind = 0; ind < poly.num_coefficients(); ind++) {
+        auto denominator = poly[ind].get_denominator();
+        common_denominator = lcm(common_denominator, denominator);
+    }
+    auto ret = std::vector<BigInt>();
+    for (uint32_t ind = 0; ind < poly.num_coefficients(); ind++) {
+        ret.push_back(poly[ind].get_numerator()*(common_denominator/poly[ind].get_denominator()));
+    }
+    return ret;
+}
+
+/**
+ * @brief Gcd over Q, computed as the gcd of the integer polynomials by the modular algorithm.
+ *
+ * The Euclidean algorithm over Q suffers from strong growth of the intermediate coefficients, which made
+ * normalizing rational functions the dominant cost of rational function arithmetic.
+ */
 template<>
 inline Polynomial<RationalNumber<BigInt>> gcd(Polynomial<RationalNumber<BigInt>> a, Polynomial<RationalNumber<BigInt>> b) {
+    auto timer = KernelTimer(POLYNOMIAL_GCD, std::max(a.num_coefficients(), b.num_coefficients()), MODULAR_GCD);
+    a.sanitize();
+    b.sanitize();
+    if (a.degree() < 0) {
+        return normalize_polynomial_gcd(b);
+    }
+    if (b.degree() < 0) {
+        return normalize_polynomial_gcd(a);
+    }
+
+    auto integer_gcd = integer_polynomial_gcd(clear_denominators(a), clear_denominators(b));
+    auto coeffs = std::vector<RationalNumber<BigInt>>();
+    for (auto& x : integer_gcd) {
+        coeffs.push_back(RationalNumber<BigInt>(x));
+    }
+    return normalize_polynomial_gcd(Polynomial<RationalNumber<BigInt>>(std::move(coeffs)));
+}
+
+template<>
+inline Polynomial<ModLong> gcd(Polynomial<ModLong> a, Polynomial<ModLong> b) {
+    auto timer = KernelTimer(POLYNOMIAL_GCD, std::max(a.num_coefficients(), b.num_coefficients()), HALF_GCD);
     auto euclidean_algo_result = extended_euclidean_algorithm(a, b);
-    euclidean_algo_result.gcd = euclidean_algo_result.gcd/euclidean_algo_result.gcd[0];
-    return euclidean_algo_result.gcd;
+    return normalize_polynomial_gcd(euclidean_algo_result.gcd);
 }
 
 template<typename T> class RingCompanionHelper<Polynomial<T>> {
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <utility>
 #include <cmath>
+#include "common/kernel_stats.hpp"
 #include "types/rationals.hpp"
 #include "exceptions/eval_exception.hpp"
 #include "types/modLong.hpp"
@@ -178,7 +179,9 @@ template<typename T> class PowerSeries: public PolyBase<T> {
         uint64_t num_zero_b = std::count(b.coefficients.begin(), b.coefficients.end(), zero);
 
         // TODO(vabi) improve the zero check; it should depend on some nicer function on the number of coefficients (n-sqrt(n)?)
-        if (size < 100 || num_zero_a > 49*a.num_coefficients()/50 || num_zero_b > 49*b.num_coefficients()/50) {
+        bool sparse = num_zero_a > 49*a.num_coefficients()/50 || num_zero_b > 49*b.num_coefficients()/50;
+        auto timer = KernelTimer(POWER_SERIES_MULTIPLY, size, size < 100 ? SCHOOLBOOK : (sparse ? SPARSE : KARATSUBA));
+        if (size < 100 || sparse) {
             auto const_a = a[0];
             auto zero = RingCompanionHelper<T>::get_zero(const_a);
             std::vector<T> coeffs = std::vector<T>(size, zero);
@@ -338,6 +341,7 @@ template<typename T> class PowerSeries: public PolyBase<T> {
      */
     PowerSeries invert() const {
         auto n = this->num_coefficients();
+        auto timer = KernelTimer(POWER_SERIES_INVERT, n, NEWTON);
         return RNI(n);
 
         // the naive implementation
@@ -454,6 +458,7 @@ template<typename T> class PowerSeries: public PolyBase<T> {
         if (!allow_constant_term && fp[0] != zero) {
             throw DatatypeInternalException("Substitution only works for power series with zero constant term");
         }
+        auto timer = KernelTimer(POWER_SERIES_COMPOSE, this->num_coefficients(), NAIVE);
         auto zero_coeffs = std::vector<T>(this->num_coefficients(), zero);
 
         auto ret = PowerSeries(std::move(zero_coeffs));
@@ -490,6 +495,37 @@ template<typename T> class PowerSeries: public PolyBase<T> {
         return ret;
     }
 
+    /**
+     * @brief Formal derivative; the result is padded with a zero to keep the number of coefficients.
+     * @return The derivative of the power series.
+    */
+    PowerSeries derivative() const {
+        auto zero = RingCompanionHelper<T>::get_zero(this->coefficients[0]);
+        auto coeffs = std::vector<T>(this->num_coefficients(), zero);
+
+        for (uint32_t ind = 1; ind < this->num_coefficients(); ind++) {
+            coeffs[ind-1] = this->coefficients[ind]*ind;
+        }
+
+        return PowerSeries(std::move(coeffs));
+    }
+
+    /**
+     * @brief Formal integral with zero constant term; the highest coefficient is dropped to keep the number of coefficients.
+     * @return The integral of the power series.
+    */
+    PowerSeries integral() const {
+        auto zero = RingCompanionHelper<T>::get_zero(this->coefficients[0]);
+        auto unit = RingCompanionHelper<T>::get_unit(this->coefficients[0]);
+        auto coeffs = std::vector<T>(this->num_coefficients(), zero);
+
+        for (uint32_t ind = 1; ind < this->num_coefficients(); ind++) {
+            coeffs[ind] = this->coefficients[ind-1]*(unit/ind);
+        }
+
+        return PowerSeries(std::move(coeffs));
+    }
+
     static PowerSeries<T> multiply_full(const PowerSeries& a, const PowerSeries& b) {
         auto ret_coeffs = multiply_full_raw(a.coefficients.data(), a.coefficients.size(), b.coefficients.data(), b.coefficients.size());
         return PowerSeries<T>(std::move(ret_coeffs));
@@ -604,16 +640,44 @@ template<typename T> class PowerSeries: public PolyBase<T> {
 
 template<typename T> using FormalPowerSeries = PowerSeries<T>;
 
-template<typename T> FormalPowerSeries<T> exp(const FormalPowerSeries<T> in) {
-    auto exp = FormalPowerSeries<T>::get_exp(in.num_coefficients(), RingCompanionHelper<T>::get_unit(in[0]));
-    return exp.substitute(in);
+/**
+ * @brief Logarithm of a power series with constant term 1, computed as the integral of in'/in.
+ *
+ * Costs a single power series division instead of a full composition.
+ */
+template<typename T> FormalPowerSeries<T> log(const FormalPowerSeries<T> in) {
+    auto unit = RingCompanionHelper<T>::get_unit(in[0]);
+    if (in[0] != unit) {
+        throw DatatypeInternalException("Logarithm only works for power series with constant term 1");
+    }
+    auto timer = KernelTimer(POWER_SERIES_LOG, in.num_coefficients(), NEWTON);
+    return (in.derivative()/in).integral();
 }
 
-template<typename T> FormalPowerSeries<T> log(const FormalPowerSeries<T> in) {
+/**
+ * @brief Exponential of a power series with constant term 0, computed by Newton iteration on log(y) = in.
+ *
+ * Every step doubles the precision via y <- y*(1+in-log(y)), so the total cost is a constant number of
+ * full precision multiplications instead of a full composition.
+ */
+template<typename T> FormalPowerSeries<T> exp(const FormalPowerSeries<T>& in) {
+    auto zero = RingCompanionHelper<T>::get_zero(in[0]);
     auto unit = RingCompanionHelper<T>::get_unit(in[0]);
-    T expansion_point = unit;
-    auto log = FormalPowerSeries<T>::get_log(expansion_point, in.num_coefficients(), unit);
-    return log.substitute(in-FormalPowerSeries<T>::get_atom(expansion_point, 0, in.num_coefficients()));
+    if (in[0] != zero) {
+        throw DatatypeInternalException("Exponential only works for power series with constant term 0");
+    }
+    auto timer = KernelTimer(POWER_SERIES_EXP, in.num_coefficients(), NEWTON);
+
+    auto ret = FormalPowerSeries<T>::get_unit(unit, 1);
+    uint32_t precision = 1;
+    while (precision < in.num_coefficients()) {
+        precision = std::min(2*precision, static_cast<uint32_t>(in.num_coefficients()));
+        ret.resize(precision);
+        auto argument = in;
+        argument.resize(precision);
+        ret = ret*(argument-log(ret)+unit);
+    }
+    return ret;
 }
 
 template<typename T> class RingCompanionHelper<FormalPowerSeries<T>> {
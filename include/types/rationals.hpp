@@ -8,6 +8,8 @@
 
 #include <string>
 #include <algorithm>
+#include <optional>
+#include "common/kernel_stats.hpp"
 #include "types/ring_helpers.hpp"
 #include "string_utils/string_utils.hpp"
 #include "types/bigint.hpp"
@@ -261,6 +263,12 @@ class RingCompanionHelper<RationalNumber<BigInt>> {
 
 template<>
 inline void RationalNumber<BigInt>::sanitize() {
+    auto timer = std::optional<KernelTimer>();
+    if (numerator.is_small_value() && denominator.is_small_value()) {
+        count_kernel_call(RATIONAL_NORMALIZE, 1, NATIVE_INTEGERS);  // too cheap to be timed
+    } else {
+        timer.emplace(RATIONAL_NORMALIZE, std::max(numerator.num_limbs(), denominator.num_limbs()), GMP_INTEGERS);
+    }
     BigInt greatest_common_div = gcd(numerator, denominator);
     auto zero = RingCompanionHelper<BigInt>::get_zero(numerator);
     if (greatest_common_div != zero) {
@@ -14,6 +14,7 @@
 #include "types/polynomial.hpp"
 #include "math/power_series/power_series_functions.hpp"
 #include "cpp_utils/unused.hpp"
+#include "exceptions/parsing_type_exception.hpp"
 #include "types/sym_types/sym_math_object.hpp"
 #include "math/combinatorics/symbolic_method/symbolic_method_core.hpp"
 #include "math/combinatorics/symbolic_method/unlabelled_symbolic.hpp"
@@ -92,6 +93,23 @@ class MathWrapperType : public SymMathObject {
      */
     virtual std::shared_ptr<MathWrapperType<T>> mult(std::shared_ptr<MathWrapperType<T>> other) = 0;
 
+    /**
+     * @brief Add another parsing wrapper to this parsing wrapper in place.
+     *
+     * Only valid if this object is referenced nowhere else and the other parsing wrapper has at most its priority,
+     * such that the result has the type of this one.
+     * @param other The other parsing wrapper.
+     */
+    virtual void add_in_place(std::shared_ptr<MathWrapperType<T>> other) = 0;
+
+    /**
+     * @brief Multiply this parsing wrapper with another parsing wrapper of lower priority in place.
+     *
+     * Only valid if this object is referenced nowhere else.
+     * @param other The other parsing wrapper.
+     */
+    virtual void mult_in_place(std::shared_ptr<MathWrapperType<T>> other) = 0;
+
     /**
      * @brief Divide this parsing wrapper by another parsing wrapper.
      * @param other The other parsing wrapper.
@@ -143,7 +161,11 @@ class MathWrapperType : public SymMathObject {
 
     virtual T get_coefficient(const uint32_t index) const = 0;
 
-    virtual std::shared_ptr<SymObject> get_coefficient_as_sym_object(const uint32_t index, const bool as_egf) const {
+    virtual std::shared_ptr<SymObject> get_coefficient_as_sym_object(const BigInt& big_index, const bool as_egf) const {
+        if (big_index > BigInt(INT32_MAX)) {
+            throw ParsingTypeException("Type error: Coefficient index too large");
+        }
+        uint32_t index = big_index.as_int64();
         auto coeff = get_coefficient(index);
 
         if (as_egf) {
@@ -59,6 +59,16 @@ class PowerSeriesType: public MathWrapperType<T> {
         return std::make_shared<PowerSeriesType<T>>(value*other->as_power_series(value.num_coefficients()));
     }
 
+    void add_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        auto summand = other->as_power_series(value.num_coefficients());
+        value = std::move(value)+summand;
+    }
+
+    void mult_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        auto factor = other->as_power_series(value.num_coefficients());
+        value = std::move(value)*factor;
+    }
+
     std::shared_ptr<MathWrapperType<T>> div(std::shared_ptr<MathWrapperType<T>> other) {
         return std::make_shared<PowerSeriesType<T>>(value/other->as_power_series(value.num_coefficients()));
     }
@@ -10,6 +10,11 @@
 #include <utility>
 #include "types/sym_types/math_types/parsing_wrapper.hpp"
 #include "types/sym_types/math_types/power_series_type.hpp"
+#include "math/power_series/rational_function_coefficients.hpp"
+#include "math/polynomials/rational_function_composition.hpp"
+
+#define RATIONAL_FUNCTION_EXPANSION_MIN_SIZE 1024  // coefficients below this index are always taken from the expansion
+#define RATIONAL_FUNCTION_EXPANSION_MAX_SIZE (1 << 20)  // the cached expansion never grows beyond this number of terms
 
 /**
  * @class RationalFunctionType
@@ -20,10 +25,56 @@ template<typename T>
 class RationalFunctionType: public MathWrapperType<T> {
  private:
     RationalFunction<T> value;
+    mutable std::shared_ptr<RationalFunctionExpansion<T>> expansion;  // cached power series expansion of value
+
+    /**
+     * @brief The cached expansion, extended to at least num_coeffs terms, or nullptr if the denominator vanishes at 0.
+     */
+    RationalFunctionExpansion<T>* get_expansion(const uint32_t num_coeffs) const {
+        if (!expansion) {
+            auto denominator = value.get_denominator();
+            if (denominator[0] == RingCompanionHelper<T>::get_zero(denominator[0])) {
+                return nullptr;
+            }
+            expansion = std::make_shared<RationalFunctionExpansion<T>>(value.get_numerator(), denominator);
+        }
+        expansion->extend(num_coeffs);
+        return expansion.get();
+    }
+
+    /**
+     * @brief Whether the coefficients of z^first, ..., z^last are best taken from the expansion: the expansion may at
+     * most double beyond the known terms or the length of the range.
+     */
+    bool use_expansion(const BigInt& first, const BigInt& last) const {
+        if (last >= BigInt(RATIONAL_FUNCTION_EXPANSION_MAX_SIZE)) {
+            return false;
+        }
+        uint64_t known = expansion ? expansion->size() : 0;
+        uint64_t count = (last-first).as_int64()+1;
+        return last < BigInt(static_cast<int64_t>(2*std::max(known, count)+RATIONAL_FUNCTION_EXPANSION_MIN_SIZE));
+    }
+
+    /**
+     * @brief The coefficient of z^index; from the cached expansion if the index is close to the known terms, else by
+     * Bostan-Mori.
+     */
+    T get_coefficient_internal(const BigInt& index) const {
+        if (use_expansion(index, index)) {
+            uint32_t idx = index.as_int64();
+            auto cached = get_expansion(idx+1);
+            if (cached) {
+                return (*cached)[idx];
+            }
+        }
+        return rational_function_coefficient(value.get_numerator(), value.get_denominator(), index);
+    }
 
  public:
     std::shared_ptr<SymObject> clone() const override {
-        return std::make_shared<RationalFunctionType<T>>(value);
+        auto ret = std::make_shared<RationalFunctionType<T>>(value);
+        ret->expansion = expansion;
+        return ret;
     }
     RationalFunctionType(RationalFunction<T> value): value(value) {}
 
@@ -37,6 +88,13 @@ class RationalFunctionType: public MathWrapperType<T> {
     }
 
     PowerSeries<T> as_power_series(uint32_t num_coeffs) const {
+        if (num_coeffs > 0 && num_coeffs <= RATIONAL_FUNCTION_EXPANSION_MAX_SIZE) {
+            auto cached = get_expansion(num_coeffs);
+            if (cached) {
+                return PowerSeries<T>(cached->get_coefficients(num_coeffs));
+            }
+        }
+
         auto num = value.get_numerator();
         auto den = value.get_denominator();
 
@@ -60,6 +118,16 @@ class RationalFunctionType: public MathWrapperType<T> {
         return std::make_shared<RationalFunctionType<T>>(value*other->as_rational_function());
     }
 
+    void add_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        value += other->as_rational_function();
+        expansion = nullptr;
+    }
+
+    void mult_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        value *= other->as_rational_function();
+        expansion = nullptr;
+    }
+
     std::shared_ptr<MathWrapperType<T>> div(std::shared_ptr<MathWrapperType<T>> other) {
         return std::make_shared<RationalFunctionType<T>>(value/other->as_rational_function());
     }
@@ -76,10 +144,12 @@ class RationalFunctionType: public MathWrapperType<T> {
 
     void unary_minus() {
         value = -value;
+        expansion = nullptr;
     }
 
     void pow(const BigInt& exponent) {
         value = value.pow(exponent);
+        expansion = nullptr;
     }
 
     void pow(const double& exponent) {
@@ -94,25 +164,7 @@ class RationalFunctionType: public MathWrapperType<T> {
     }
 
     std::shared_ptr<MathWrapperType<T>> insert_into_rational_function(const RationalFunction<T>& rat_function) {
-        auto numerator = rat_function.get_numerator();
-        auto numerator_ev = RationalFunction<T>(Polynomial<T>::get_zero(numerator[0]), Polynomial<T>::get_unit(numerator[0]));
-        auto pw = RationalFunction<T>(Polynomial<T>::get_unit(numerator[0]), Polynomial<T>::get_unit(numerator[0]));
-
-        for (uint32_t ind = 0; ind < numerator.num_coefficients(); ind++) {
-            numerator_ev = numerator_ev+Polynomial<T>::get_atom(numerator[ind], 0)*pw;
-            pw = pw*value;
-        }
-
-        auto denominator = rat_function.get_denominator();
-        auto denominator_ev = RationalFunction<T>(Polynomial<T>::get_zero(numerator[0]), Polynomial<T>::get_unit(numerator[0]));
-
-        pw = RationalFunction<T>(Polynomial<T>::get_unit(numerator[0]), Polynomial<T>::get_unit(numerator[0]));
-
-        for (uint32_t ind = 0; ind < denominator.num_coefficients(); ind++) {
-            denominator_ev = denominator_ev+Polynomial<T>::get_atom(denominator[ind], 0)*pw;
-            pw = pw*value;
-        }
-        return std::make_shared<RationalFunctionType<T>>(numerator_ev/denominator_ev);
+        return std::make_shared<RationalFunctionType<T>>(compose_rational_functions(rat_function, value));
     }
 
     std::shared_ptr<MathWrapperType<T>> insert_into_power_series(const PowerSeries<T>& power_series) {
@@ -144,7 +196,22 @@ class RationalFunctionType: public MathWrapperType<T> {
     Datatype get_type() const override;
 
     T get_coefficient(const uint32_t index) const override {
-        return this->as_power_series(index+1)[index];
+        return get_coefficient_internal(BigInt(index));
+    }
+
+    std::shared_ptr<SymObject> get_coefficient_as_sym_object(const BigInt& index, const bool as_egf) const override {
+        if (as_egf) {
+            // the factorial limits the index anyway
+            return MathWrapperType<T>::get_coefficient_as_sym_object(index, as_egf);
+        }
+        return create_value_type(get_coefficient_internal(index));
+    }
+
+    std::vector<std::shared_ptr<SymObject>> get_coefficients_as_sym_objects(const BigInt& first, const BigInt& last) const override {
+        if (first <= last && use_expansion(first, last)) {
+            get_expansion(last.as_int64()+1);
+        }
+        return MathWrapperType<T>::get_coefficients_as_sym_objects(first, last);
     }
 
     std::shared_ptr<SymMathObject> as_double() const override {
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <typeinfo>
 #include "types/sym_types/math_types/parsing_wrapper.hpp"
 #include "types/sym_types/math_types/rational_function_type.hpp"
 #include "types/sym_types/math_types/power_series_type.hpp"
@@ -41,6 +42,10 @@ class ValueType: public MathWrapperType<T> {
         return value;
     }
 
+    const T& get_value() const {
+        return value;
+    }
+
     RationalFunction<T> as_rational_function() {
         return RationalFunction<T>(Polynomial<T>(std::vector<T>{value}));
     }
@@ -64,6 +69,14 @@ class ValueType: public MathWrapperType<T> {
         return std::make_shared<ValueType<T>>(value*other->as_value());
     }
 
+    void add_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        value += other->as_value();
+    }
+
+    void mult_in_place(std::shared_ptr<MathWrapperType<T>> other) {
+        value *= other->as_value();
+    }
+
     std::string to_string() const {
         std::stringstream ss;
         ss << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
@@ -137,6 +150,40 @@ class ValueType: public MathWrapperType<T> {
     }
 };
 
+/**
+ * @brief Reads an integer which fits into a machine word, the representation BigInt uses for small values.
+ *
+ * The interpreter computes with such integers natively, without boxing them into BigInt arithmetic and without the
+ * gcd normalisation of rationals, and falls back to the generic operations for other values or on overflow.
+ *
+ * @param object The object.
+ * @param out The integer, if the object is one.
+ * @return Whether the object is a rational number with denominator 1 and a small numerator.
+ */
+inline bool get_small_integer(const SymObject& object, int64_t& out) {
+    if (typeid(object) != typeid(ValueType<RationalNumber<BigInt>>)) {
+        return false;
+    }
+    auto& value = static_cast<const ValueType<RationalNumber<BigInt>>&>(object).get_value();
+    auto denominator = value.get_denominator();
+    if (!denominator.is_small_value() || denominator.as_int64() != 1) {
+        return false;
+    }
+    auto numerator = value.get_numerator();
+    if (!numerator.is_small_value()) {
+        return false;
+    }
+    out = numerator.as_int64();
+    return true;
+}
+
+/**
+ * @brief Creates the rational number value of an integer, which needs no normalisation.
+ */
+inline std::shared_ptr<ValueType<RationalNumber<BigInt>>> make_small_integer(int64_t value) {
+    return std::make_shared<ValueType<RationalNumber<BigInt>>>(RationalNumber<BigInt>(BigInt(value)));
+}
+
 template<>
 inline std::shared_ptr<SymMathObject> ValueType<RationalNumber<BigInt>>::as_modlong(const int64_t& modulus) const {
     if (value.get_denominator() == BigInt(0)) {
@@ -189,6 +236,10 @@ inline bool ValueType<double>::equals(const std::shared_ptr<SymObject>& other) c
 
 template<>
 inline bool ValueType<RationalNumber<BigInt>>::equals(const std::shared_ptr<SymObject>& other) const {
+    int64_t small_value, other_small_value;
+    if (other && get_small_integer(*this, small_value) && get_small_integer(*other, other_small_value)) {
+        return small_value == other_small_value;
+    }
     auto other_value = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(other);
     if (!other_value) {
         auto double_value = std::dynamic_pointer_cast<ValueType<double>>(other);
@@ -32,7 +32,8 @@ class SymDictObject: public SymObject {
         std::map<std::string, std::shared_ptr<SymObjectContainer>> copied;
         for (const auto& entry : data) {
             if (entry.second) {
-                copied[entry.first] = std::make_shared<SymObjectContainer>(entry.second->get_object()->clone());
+                auto object = entry.second->get_object();
+                copied[entry.first] = std::make_shared<SymObjectContainer>(object->modifiable_in_place() ? object->clone() : object);
             } else {
                 copied[entry.first] = nullptr;
             }
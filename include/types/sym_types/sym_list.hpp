@@ -27,7 +27,8 @@ class SymListObject: public SymObject {
     std::shared_ptr<SymObject> clone() const override {
         auto cloned_data = std::vector<std::shared_ptr<SymObjectContainer>>();
         for (const auto& element : data) {
-            cloned_data.push_back(std::make_shared<SymObjectContainer>(element->get_object()->clone()));
+            auto object = element->get_object();
+            cloned_data.push_back(std::make_shared<SymObjectContainer>(object->modifiable_in_place() ? object->clone() : object));
         }
         return std::make_shared<SymListObject>(cloned_data);
     }
@@ -6,3 +6,12 @@ std::shared_ptr<SymMathObject> sym_add(std::shared_ptr<SymMathObject> a, std::sh
 std::shared_ptr<SymMathObject> sym_subtract(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
 std::shared_ptr<SymMathObject> sym_multiply(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
 std::shared_ptr<SymMathObject> sym_divide(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
+
+/**
+ * @brief Like sym_add, sym_subtract and sym_multiply, but a may be updated in place and returned as the result.
+ *
+ * Only to be used if a is referenced nowhere else, since values are otherwise shared as immutable objects.
+ */
+std::shared_ptr<SymMathObject> sym_add_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
+std::shared_ptr<SymMathObject> sym_subtract_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
+std::shared_ptr<SymMathObject> sym_multiply_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b);
@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <vector>
 #include "types/sym_types/sym_object.hpp"
 #include "types/modLong.hpp"
 #include "math/power_series/power_series_functions.hpp"
@@ -30,7 +31,18 @@ class SymMathObject: public SymObject {
 
     virtual void pow(const double& exponent) = 0;
 
-    virtual std::shared_ptr<SymObject> get_coefficient_as_sym_object(const uint32_t index, const bool as_egf) const = 0;
+    virtual std::shared_ptr<SymObject> get_coefficient_as_sym_object(const BigInt& index, const bool as_egf) const = 0;
+
+    /**
+     * @brief The coefficients of z^first, ..., z^last.
+     */
+    virtual std::vector<std::shared_ptr<SymObject>> get_coefficients_as_sym_objects(const BigInt& first, const BigInt& last) const {
+        auto ret = std::vector<std::shared_ptr<SymObject>>();
+        for (auto index = first; index <= last; index += 1) {
+            ret.push_back(get_coefficient_as_sym_object(index, false));
+        }
+        return ret;
+    }
 
     virtual std::shared_ptr<SymObject> symbolic_method(const SymbolicMethodOperator& op, const uint32_t fp_size, const Subset& subset) = 0;
 
@@ -10,6 +10,14 @@ class SymObject {
     virtual ~SymObject() = default;
     virtual std::string to_string() const = 0;
     virtual std::shared_ptr<SymObject> clone() const = 0;
+
+    /**
+     * @brief Whether the object is mutable and shared by reference, like lists and dicts.
+     *
+     * All other objects are immutable once created: variables, constants and list elements share them, and operations
+     * that change a value in place (unary_minus, pow) have to be applied to a clone, unless the interpreter knows the
+     * object to be referenced nowhere else.
+     */
     virtual bool modifiable_in_place() const {
         return false;
     }
@@ -16,4 +16,11 @@ class SymStringObject: public SymObject {
     std::shared_ptr<SymObject> clone() const override {
         return std::make_shared<SymStringObject>(data);
     }
+
+    /**
+     * @brief Appends to the string in place; only valid if the object is referenced nowhere else.
+     */
+    void append(const std::string& suffix) {
+        data += suffix;
+    }
 };
@@ -0,0 +1,120 @@
+#include <string>
+#include "common/kernel_stats.hpp"
+
+static const char* kernel_operation_names[NUM_KERNEL_OPERATIONS] = {
+    "power series multiplication",
+    "power series inversion",
+    "power series exp",
+    "power series log",
+    "power series composition",
+    "polynomial multiplication",
+    "polynomial division",
+    "polynomial gcd",
+    "rational normalization"
+};
+
+static const char* kernel_algorithm_names[NUM_KERNEL_ALGORITHMS] = {
+    "schoolbook",
+    "sparse",
+    "karatsuba",
+    "newton",
+    "naive",
+    "euclidean",
+    "half gcd",
+    "modular",
+    "native integers",
+    "gmp"
+};
+
+static std::string get_time_bucket_name(uint32_t bucket) {
+    static const char* limits[KERNEL_TIME_BUCKETS] = {"1us", "10us", "100us", "1ms", "10ms", "100ms", "1s", ""};
+    if (bucket == 0) {
+        return std::string("<")+limits[0];
+    }
+    if (bucket == KERNEL_TIME_BUCKETS-1) {
+        return std::string(">=")+limits[bucket-1];
+    }
+    return std::string(limits[bucket-1])+"-"+limits[bucket];
+}
+
+static std::string get_size_bucket_name(uint32_t bucket) {
+    if (bucket == 0) {
+        return "0";
+    }
+    auto lower = std::to_string(uint64_t(1) << (bucket-1));
+    if (bucket == KERNEL_SIZE_BUCKETS-1) {
+        return std::string(">=")+lower;
+    }
+    return lower+"-"+std::to_string((uint64_t(1) << bucket)-1);
+}
+
+void write_kernel_statistics(std::ostream& stream) {
+    bool any_calls = false;
+    for (uint32_t operation = 0; operation < NUM_KERNEL_OPERATIONS; operation++) {
+        auto& counters = kernel_counters[operation];
+        uint64_t calls = counters.calls.load(std::memory_order_relaxed);
+        if (calls == 0) {
+            continue;
+        }
+        any_calls = true;
+
+        stream << kernel_operation_names[operation] << ": " << calls << " calls, mean size "
+               << counters.total_size.load(std::memory_order_relaxed)/calls << ", max size " << counters.max_size.load(std::memory_order_relaxed);
+        uint64_t timed_calls = counters.timed_calls.load(std::memory_order_relaxed);
+        if (timed_calls > 0) {
+            stream << ", " << counters.nanoseconds.load(std::memory_order_relaxed)/1000000.0 << " ms in " << timed_calls << " timed calls";
+        }
+        stream << std::endl;
+
+        stream << "    algorithms:";
+        for (uint32_t algorithm = 0; algorithm < NUM_KERNEL_ALGORITHMS; algorithm++) {
+            uint64_t count = counters.algorithms[algorithm].load(std::memory_order_relaxed);
+            if (count > 0) {
+                stream << " " << kernel_algorithm_names[algorithm] << " " << count;
+            }
+        }
+        stream << std::endl;
+
+        stream << "    sizes:";
+        for (uint32_t bucket = 0; bucket < KERNEL_SIZE_BUCKETS; bucket++) {
+            uint64_t count = counters.sizes[bucket].load(std::memory_order_relaxed);
+            if (count > 0) {
+                stream << " " << get_size_bucket_name(bucket) << ": " << count;
+            }
+        }
+        stream << std::endl;
+
+        if (timed_calls > 0) {
+            stream << "    times:";
+            for (uint32_t bucket = 0; bucket < KERNEL_TIME_BUCKETS; bucket++) {
+                uint64_t count = counters.times[bucket].load(std::memory_order_relaxed);
+                if (count > 0) {
+                    stream << " " << get_time_bucket_name(bucket) << ": " << count;
+                }
+            }
+            stream << std::endl;
+        }
+    }
+    if (!any_calls) {
+        stream << "No kernel calls recorded" << std::endl;
+    }
+}
+
+void reset_kernel_statistics() {
+    for (auto& counters : kernel_counters) {
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.timed_calls.store(0, std::memory_order_relaxed);
+        counters.nanoseconds.store(0, std::memory_order_relaxed);
+        counters.total_size.store(0, std::memory_order_relaxed);
+        counters.max_size.store(0, std::memory_order_relaxed);
+        for (auto& count : counters.algorithms) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        for (auto& count : counters.sizes) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        for (auto& count : counters.times) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <utility>
 #include "interpreter/context.hpp"
+#include "interpreter/polish_notation/polish_function_core.hpp"
 #include "types/sym_types/sym_boolean.hpp"
 #include "types/sym_types/sym_void.hpp"
 #include "exceptions/parsing_type_exception.hpp"
@@ -20,12 +21,44 @@ void InterpreterContext::initialize_constants() {
     constants["null"] = std::make_shared<SymVoidObject>();
 }
 
+// Start the profiler according to the shell parameters, keeping the samples of previous evaluations
+SamplingProfiler* InterpreterContext::start_profiler() {
+    if (shell_parameters.profile_file.empty()) {
+        profiler = nullptr;
+        return nullptr;
+    }
+    if (!profiler) {
+        profiler = std::make_unique<SamplingProfiler>();
+    }
+    current_position = nullptr;
+    profiler->start(steps);
+    return profiler.get();
+}
+
+// Record a sample of the running profiler; called when the timer has set profiler_sample_due
+void InterpreterContext::record_profiler_sample() {
+    profiler_sample_due = 0;
+    if (profiler && profiler->is_running()) {
+        profiler->record_sample(current_position, steps, shared_from_this());
+    }
+}
+
+// Leave a call entered with enter_profiled_call
+void InterpreterContext::leave_profiled_call() {
+    // module functions take no steps, so a sample due during their execution has to be taken before they are left
+    if (profiler_sample_due) {
+        record_profiler_sample();
+    }
+    current_position = profiler->leave();
+}
+
 // Pop the current variable scope with error checking
 void InterpreterContext::pop_variables() {
-    if (variables.empty()) {
+    if (frames.empty()) {
         throw ParsingTypeException("Attempted to pop variable scope when no scopes are available");
     }
-    variables.pop();
+    frame_slots.resize(frames.back().base);
+    frames.pop_back();
 }
 
 // Retrieve a file navigator by file name with error handling
@@ -46,15 +79,30 @@ std::shared_ptr<PolishCustomFunction> InterpreterContext::get_custom_function(co
     return nullptr;
 }
 
+// Call a custom function from outside the interpreter loop, e.g. from a module function
+std::shared_ptr<SymObject> InterpreterContext::call_custom_function(const std::string& name, const std::vector<std::shared_ptr<SymObject>>& args) {
+    auto func = get_custom_function(name);
+    if (!func) {
+        throw ParsingTypeException("Unknown function: " + name);
+    }
+    auto self = shared_from_this();
+    return func->call(args, self);
+}
+
 // Retrieve a variable from the current scope or constants
 std::shared_ptr<SymObject> InterpreterContext::get_variable(const std::string& name) {
-    auto current_vars = variables.empty() ? nullptr : &variables.top();
-
-    if (!current_vars) {
+    if (frames.empty()) {
         throw ParsingTypeException("No variable scope available when trying to access variable: " + name);
     }
-    auto it = current_vars->find(name);
-    if (it != current_vars->end()) {
+    auto& frame = frames.back();
+    if (frame.layout) {
+        auto slot = frame.layout->find_slot(name);
+        if (slot >= 0) {  // constants have no slots
+            return frame_slots[frame.base+slot];
+        }
+    }
+    auto it = frame.named_variables.find(name);
+    if (it != frame.named_variables.end()) {
         return it->second;
     }
     auto const_it = constants.find(name);
@@ -69,16 +117,32 @@ void InterpreterContext::set_variable(const std::string& name, std::shared_ptr<S
     if (constants.find(name) != constants.end()) {
         throw ParsingTypeException("Cannot modify constant: " + name);
     }
-    if (variables.empty()) {
+    if (frames.empty()) {
         throw ParsingTypeException("No variable scope available when trying to set variable: " + name);
     }
-    variables.top()[name] = value;
+    auto& frame = frames.back();
+    if (frame.layout) {
+        auto slot = frame.layout->find_slot(name);
+        if (slot >= 0) {
+            frame_slots[frame.base+slot] = value;
+            return;
+        }
+    }
+    frame.named_variables[name] = value;
 }
 
 std::vector<std::string> InterpreterContext::get_autocompletable_names() const {
     std::vector<std::string> names;
-    if (!variables.empty()) {
-        for (const auto& pair : variables.top()) {
+    if (!frames.empty()) {
+        auto& frame = frames.back();
+        if (frame.layout) {
+            for (const auto& pair : frame.layout->get_slots()) {
+                if (frame_slots[frame.base+pair.second]) {
+                    names.push_back(pair.first);
+                }
+            }
+        }
+        for (const auto& pair : frame.named_variables) {
             names.push_back(pair.first);
         }
     }
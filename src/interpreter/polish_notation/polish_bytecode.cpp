@@ -0,0 +1,549 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "interpreter/polish_notation/polish_bytecode.hpp"
+#include "interpreter/polish_notation/polish_tree.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/polish_notation/polish_base_math.hpp"
+#include "interpreter/polish_notation/polish_control_flow.hpp"
+#include "interpreter/polish_notation/polish_function_core.hpp"
+#include "interpreter/polish_notation/polish_list.hpp"
+#include "interpreter/polish_notation/polish_optimized.hpp"
+#include "interpreter/context.hpp"
+#include "common/subset_parser.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+#include "exceptions/eval_exception.hpp"
+#include "exceptions/parsing_type_exception.hpp"
+#include "types/sym_types/sym_boolean.hpp"
+#include "types/sym_types/sym_void.hpp"
+
+typedef LexerDeque<std::shared_ptr<PolishNotationElement>> PolishProgram;
+
+/**
+ * @brief Adds the variables assigned in node to layout; nested function definitions have scopes of their own.
+ */
+static void add_assigned_variables(const PolishNode& node, FrameLayout& layout, const std::shared_ptr<InterpreterContext>& context) {
+    if (node.kind == DEFINITION_NODE) {
+        return;
+    }
+    if ((node.kind == ASSIGN_NODE || node.kind == FOR_NODE) && node.children[0].kind == VARIABLE_NODE) {
+        auto& name = node.children[0].element->get_data();
+        if (name != "_" && name.find('.') == std::string::npos && !context->is_constant(name)) {
+            layout.add_variable(name);
+        }
+    }
+    for (const auto& child : node.children) {
+        add_assigned_variables(child, layout, context);
+    }
+    for (const auto& statement : node.block) {
+        add_assigned_variables(statement, layout, context);
+    }
+}
+
+class BytecodeCompiler {
+    std::shared_ptr<InterpreterContext>& context;
+    std::shared_ptr<FrameLayout> layout;
+    std::shared_ptr<BytecodeProgram> program;
+
+    uint32_t emit(BytecodeOperation operation, const std::shared_ptr<PolishNotationElement>& element = nullptr, uint32_t argument = 0,
+                  const std::string& name = "") {
+        program->code.push_back(BytecodeInstruction{operation, argument, element, nullptr, name, nullptr, {}});
+        return program->code.size()-1;
+    }
+
+    void emit_constant(const std::shared_ptr<SymObject>& constant) {
+        program->code.push_back(BytecodeInstruction{PUSH_CONSTANT, 0, nullptr, constant, "", nullptr, {}});
+    }
+
+    void emit_fallback(const PolishNode& node) {
+        program->fallbacks.push_back(serialize_polish_tree({node}));
+        emit(EVALUATE_FALLBACK, node.element, program->fallbacks.size()-1);
+    }
+
+    /**
+     * @brief Points the jump at the given index to the next instruction.
+     */
+    void resolve_jump(uint32_t jump) {
+        program->code[jump].argument = program->code.size();
+    }
+
+    int64_t find_slot(const std::string& name) const {
+        return layout ? layout->find_slot(name) : -1;
+    }
+
+    /**
+     * @brief Emits the assignment of the top of the stack to a variable.
+     *
+     * @param element The element errors are reported at.
+     */
+    void emit_store(const std::string& name, const std::shared_ptr<PolishNotationElement>& element) {
+        auto slot = find_slot(name);
+        if (slot >= 0) {
+            emit(STORE_LOCAL, element, slot, name);
+        } else {
+            emit(STORE_VARIABLE, element, 0, name);
+        }
+    }
+
+    void compile_statements(const std::vector<PolishNode>& block, bool keep_last_value) {
+        for (uint32_t ind = 0; ind < block.size(); ind++) {
+            compile_node(block[ind]);
+            if (!keep_last_value || ind+1 < block.size()) {
+                emit(POP);
+            }
+        }
+        if (keep_last_value && block.empty()) {
+            emit_constant(std::make_shared<SymVoidObject>());
+        }
+    }
+
+    /**
+     * @brief Whether value computes a new value of the variable name from its old one, like a+x in a = a+x.
+     */
+    bool is_update_of(const PolishNode& value, const std::string& name) const {
+        if (value.kind != OPERATOR_NODE || value.children.size() != 2 || context->is_constant(name)) {
+            return false;
+        }
+        auto type = value.element->get_type();
+        if (type != INFIX_PLUS && type != INFIX_MINUS && type != INFIX_MULTIPLY) {
+            return false;
+        }
+        auto& left = value.children[0];
+        return left.kind == VARIABLE_NODE && left.element->get_data() == name;
+    }
+
+    /**
+     * @brief Compiles an update of a variable. The old value is overwritten by the result right after, so the
+     * operator can update it in place if the variable is its only other reference.
+     */
+    void compile_update(const PolishNode& value, const std::string& name) {
+        compile_node(value.children[0]);
+        compile_node(value.children[1]);
+        auto slot = find_slot(name);
+        emit(get_operator(value.element->get_type()), value.element, slot >= 0 ? slot : NO_SLOT, name);
+    }
+
+    void compile_assignment(const PolishNode& node) {
+        auto& target = node.children[0];
+        if (target.kind == VARIABLE_NODE) {
+            auto& name = target.element->get_data();
+            if (name != "_" && name.find('.') == std::string::npos) {
+                if (is_update_of(node.children[1], name)) {
+                    compile_update(node.children[1], name);
+                } else {
+                    compile_node(node.children[1]);
+                }
+                emit_store(name, node.element);
+                return;
+            }
+        } else if (target.kind == SUBSCRIPT_NODE && target.block.size() == 1) {
+            compile_node(target.children[0]);
+            compile_node(target.block[0]);
+            emit(LOAD_SUBSCRIPT_TARGET, target.element);
+            compile_node(node.children[1]);
+            emit(STORE_SUBSCRIPT, node.element);
+            return;
+        }
+        emit_fallback(node);  // reports the invalid assignment
+    }
+
+    void compile_for(const PolishNode& node) {
+        auto& variable = node.children[0].element;
+        emit(ENTER_LOOP, node.element);
+        compile_node(node.children[1]);
+        compile_node(node.children[2]);
+        emit(FOR_INIT, variable);
+        auto next = emit(FOR_NEXT);
+        emit_store(variable->get_data(), node.element);
+        emit(POP);
+        compile_statements(node.children[3].block, false);
+        emit(JUMP, nullptr, next);
+        resolve_jump(next);
+        emit_constant(std::make_shared<SymVoidObject>());
+    }
+
+    void compile_while(const PolishNode& node) {
+        emit(ENTER_LOOP, node.element);
+        uint32_t start = program->code.size();
+        compile_node(node.children[0]);
+        auto exit = emit(JUMP_IF_FALSE, node.element);
+        compile_statements(node.children[1].block, false);
+        emit(JUMP, nullptr, start);
+        resolve_jump(exit);
+        emit_constant(std::make_shared<SymVoidObject>());
+    }
+
+    /**
+     * @brief Compiles an if statement with its elif branches. As in PolishIf, the conditions of the branches after
+     * the one taken are still evaluated.
+     */
+    void compile_if(const PolishNode& node) {
+        auto branches = std::vector<const PolishNode*>({&node});
+        while (branches.back()->children.size() > 2) {
+            branches.push_back(&branches.back()->children[2]);
+        }
+
+        auto exits = std::vector<uint32_t>();
+        for (uint32_t ind = 0; ind < branches.size(); ind++) {
+            compile_node(branches[ind]->children[0]);
+            auto skip = emit(JUMP_IF_FALSE, branches[ind]->element);
+            compile_statements(branches[ind]->children[1].block, false);
+            for (uint32_t later = ind+1; later < branches.size(); later++) {
+                compile_node(branches[later]->children[0]);
+                emit(CHECK_CONDITION, branches[later]->element);
+            }
+            exits.push_back(emit(JUMP));
+            resolve_jump(skip);
+        }
+        for (auto exit : exits) {
+            resolve_jump(exit);
+        }
+        emit_constant(std::make_shared<SymVoidObject>());
+    }
+
+    /**
+     * @brief Compiles a call of a custom function. If the function is not defined when the call is executed,
+     * PolishCustomFunction would try to define it, so the call is handed to the tree walker then.
+     */
+    void compile_call(const PolishNode& node) {
+        auto prepare = emit(PREPARE_CALL, node.element);
+        for (const auto& child : node.children) {
+            compile_node(child);
+        }
+        emit(CALL_FUNCTION, node.element);
+        auto exit = emit(JUMP);
+        resolve_jump(prepare);
+        emit_fallback(node);
+        resolve_jump(exit);
+    }
+
+    static BytecodeOperation get_operator(expression_type type) {
+        switch (type) {
+            case INFIX_PLUS:
+                return ADD;
+            case INFIX_MINUS:
+                return SUBTRACT;
+            case INFIX_MULTIPLY:
+                return MULTIPLY;
+            case INFIX_DIVIDE:
+                return DIVIDE;
+            case INFIX_POWER:
+                return POWER;
+            case UNARY_MINUS:
+                return NEGATE;
+            default:
+                return PLUS_SIGN;
+        }
+    }
+
+    void compile_node(const PolishNode& node) {
+        switch (node.kind) {
+            case CONSTANT_NODE: {
+                auto no_operands = PolishProgram();
+                emit_constant(node.element->handle_wrapper(no_operands, context)->get_object());
+                return;
+            }
+            case VARIABLE_NODE: {
+                auto slot = find_slot(node.element->get_data());
+                if (slot >= 0) {
+                    emit(LOAD_LOCAL, node.element, slot, node.element->get_data());
+                } else {
+                    emit(LOAD_VARIABLE, node.element, 0, node.element->get_data());
+                }
+                return;
+            }
+            case OPERATOR_NODE:
+                for (const auto& child : node.children) {
+                    compile_node(child);
+                }
+                emit(get_operator(node.element->get_type()), node.element);
+                return;
+            case MODULE_CALL_NODE:
+                for (const auto& child : node.children) {
+                    compile_node(child);
+                }
+                emit(CALL_MODULE, node.element);
+                return;
+            case ASSIGN_NODE:
+                compile_assignment(node);
+                return;
+            case FOR_NODE:
+                compile_for(node);
+                return;
+            case WHILE_NODE:
+                compile_while(node);
+                return;
+            case IF_NODE:
+                compile_if(node);
+                return;
+            case CALL_NODE:
+                compile_call(node);
+                return;
+            case SUBSCRIPT_NODE:
+                if (node.block.size() == 1) {
+                    compile_node(node.children[0]);
+                    compile_node(node.block[0]);
+                    emit(SUBSCRIPT, node.element);
+                    return;
+                }
+                break;
+            case OTHER_NODE:
+                if (std::dynamic_pointer_cast<PolishLoopInvariant>(node.element)) {
+                    emit(EVALUATE_ELEMENT, node.element);
+                    return;
+                }
+                break;
+            default:  // function definitions and scopes outside of control flow
+                break;
+        }
+        emit_fallback(node);
+    }
+
+ public:
+    BytecodeCompiler(std::shared_ptr<InterpreterContext>& context, const std::shared_ptr<FrameLayout>& layout):
+        context(context), layout(layout), program(std::make_shared<BytecodeProgram>()) { }
+
+    std::shared_ptr<BytecodeProgram> compile(const std::vector<PolishNode>& statements) {
+        if (layout) {
+            for (const auto& statement : statements) {
+                add_assigned_variables(statement, *layout, context);
+            }
+        }
+        compile_statements(statements, true);
+        return program;
+    }
+};
+
+std::shared_ptr<BytecodeProgram> compile_bytecode(const PolishProgram& program, std::shared_ptr<InterpreterContext>& context,
+                                                  const std::shared_ptr<FrameLayout>& layout) {
+    try {
+        return BytecodeCompiler(context, layout).compile(parse_polish_tree(program, true));
+    } catch (PolishTreeException&) {
+        return nullptr;
+    }
+}
+
+static inline std::shared_ptr<SymObject> pop_value(std::vector<std::shared_ptr<SymObject>>& stack) {
+    auto ret = std::move(stack.back());
+    stack.pop_back();
+    return ret;
+}
+
+static inline bool pop_condition(std::vector<std::shared_ptr<SymObject>>& stack, const BytecodeInstruction& instruction) {
+    auto condition = dynamic_cast<SymBooleanObject*>(stack.back().get());
+    if (!condition) {
+        auto statement = instruction.element->get_data() == "while" ? "while statement" : "if statement";
+        throw EvalException(std::string("Expected boolean condition in ") + statement, instruction.element->get_position());
+    }
+    bool ret = condition->as_boolean();
+    stack.pop_back();
+    return ret;
+}
+
+/**
+ * @brief Whether the left operand of an operator, on top of the stack, can be updated in place: nothing else refers
+ * to it, or only the variable the result is assigned to, for updates like a = a+x.
+ */
+static inline bool left_operand_unique(const std::shared_ptr<SymObject>& operand, const BytecodeInstruction& instruction,
+                                       std::shared_ptr<InterpreterContext>& context) {
+    auto count = operand.use_count();
+    if (count == 1) {
+        return true;
+    }
+    if (count != 2 || instruction.name.empty()) {
+        return false;
+    }
+    if (instruction.argument != NO_SLOT) {
+        return context->get_local(instruction.argument) == operand;
+    }
+    return context->get_variable(instruction.name) == operand;
+}
+
+static CodePlaceIdentifier get_instruction_position(const BytecodeInstruction& instruction) {
+    return instruction.element ? instruction.element->get_position() : CodePlaceIdentifier::unknown();
+}
+
+std::shared_ptr<SymObject> run_bytecode(const BytecodeProgram& program, std::shared_ptr<InterpreterContext>& context) {
+    auto stack = std::vector<std::shared_ptr<SymObject>>();
+    auto loops = std::vector<std::pair<int64_t, int64_t>>();  // current and last value of the active for loops
+    auto functions = std::vector<PolishCustomFunction*>();  // kept alive by the context
+    auto targets = std::vector<std::shared_ptr<SymObjectContainer>>();
+    auto no_operands = PolishProgram();
+    auto& code = program.code;
+    uint32_t pc = 0;
+
+    try {
+        while (pc < code.size()) {
+            auto& instruction = code[pc++];
+            #if DEBUG_EXECUTION
+            if (instruction.element) {
+                instruction.element->debug_print(std::cout, context);
+            }
+            #endif
+            context->increment_steps(instruction.element ? &instruction.element->get_base_element().position : nullptr);
+            switch (instruction.operation) {
+                case PUSH_CONSTANT:
+                    stack.push_back(instruction.constant);
+                    break;
+                case LOAD_VARIABLE:
+                    stack.push_back(get_variable_value(instruction.name, context, instruction.binding));
+                    break;
+                case STORE_VARIABLE:
+                    context->set_variable(instruction.name, stack.back());
+                    break;
+                case LOAD_LOCAL: {
+                    auto& value = context->get_local(instruction.argument);
+                    stack.push_back(value ? value : get_variable_value(instruction.name, context, instruction.binding));
+                    break;
+                }
+                case STORE_LOCAL:
+                    context->set_local(instruction.argument, stack.back());
+                    break;
+                case POP:
+                    stack.pop_back();
+                    break;
+                case ADD: {
+                    auto right = pop_value(stack);
+                    stack.back() = evaluate_plus(stack.back(), right, left_operand_unique(stack.back(), instruction, context));
+                    break;
+                }
+                case SUBTRACT: {
+                    auto right = pop_value(stack);
+                    auto in_place = left_operand_unique(stack.back(), instruction, context);
+                    stack.back() = evaluate_math_operation(stack.back(), right, in_place ? sym_subtract_in_place : sym_subtract);
+                    break;
+                }
+                case MULTIPLY: {
+                    auto right = pop_value(stack);
+                    auto in_place = left_operand_unique(stack.back(), instruction, context);
+                    stack.back() = evaluate_math_operation(stack.back(), right, in_place ? sym_multiply_in_place : sym_multiply);
+                    break;
+                }
+                case DIVIDE: {
+                    auto right = pop_value(stack);
+                    stack.back() = evaluate_math_operation(stack.back(), right, sym_divide);
+                    break;
+                }
+                case POWER: {
+                    auto right = pop_value(stack);
+                    stack.back() = evaluate_pow(stack.back(), right, instruction.element->get_position());
+                    break;
+                }
+                case NEGATE:
+                    stack.back() = evaluate_unary_minus(stack.back());
+                    break;
+                case PLUS_SIGN:
+                    stack.back() = evaluate_unary_plus(stack.back());
+                    break;
+                case CALL_MODULE: {
+                    auto function = static_cast<PolishModuleFunction*>(instruction.element.get());
+                    auto num_args = function->get_num_args();
+                    auto arg_values = std::vector<std::shared_ptr<SymObjectContainer>>();
+                    for (auto it = stack.end()-num_args; it != stack.end(); it++) {
+                        arg_values.push_back(std::make_shared<SymObjectContainer>(*it));
+                    }
+                    stack.resize(stack.size()-num_args);
+                    stack.push_back(function->call(arg_values, context)->get_object());
+                    break;
+                }
+                case PREPARE_CALL: {
+                    if (!instruction.function) {  // functions cannot be redefined, so the lookup is done only once
+                        instruction.function = context->get_custom_function(instruction.element->get_data()).get();
+                        if (!instruction.function) {
+                            pc = instruction.argument;
+                            break;
+                        }
+                    }
+                    auto function = instruction.function;
+                    if (instruction.element->get_num_args() != function->get_num_args()) {
+                        throw EvalException("Function " + instruction.element->get_data() + " called with incorrect number of arguments: "+
+                            std::to_string(instruction.element->get_num_args()) + ", expected " + std::to_string(function->get_num_args()),
+                            instruction.element->get_position());
+                    }
+                    functions.push_back(function);
+                    break;
+                }
+                case CALL_FUNCTION: {
+                    auto function = functions.back();
+                    functions.pop_back();
+                    auto num_args = instruction.element->get_num_args();
+                    auto ret = function->call(stack.data()+stack.size()-num_args, num_args, context);
+                    stack.resize(stack.size()-num_args);
+                    stack.push_back(std::move(ret));
+                    break;
+                }
+                case SUBSCRIPT: {
+                    auto index = pop_value(stack);
+                    stack.back() = access_subscript(stack.back(), index)->get_object();
+                    break;
+                }
+                case LOAD_SUBSCRIPT_TARGET: {
+                    auto index = pop_value(stack);
+                    auto target = pop_value(stack);
+                    targets.push_back(access_subscript(target, index));
+                    break;
+                }
+                case STORE_SUBSCRIPT:
+                    targets.back()->set_object(stack.back());
+                    targets.pop_back();
+                    break;
+                case JUMP:
+                    pc = instruction.argument;
+                    break;
+                case JUMP_IF_FALSE:
+                    if (!pop_condition(stack, instruction)) {
+                        pc = instruction.argument;
+                    }
+                    break;
+                case CHECK_CONDITION:
+                    pop_condition(stack, instruction);
+                    break;
+                case ENTER_LOOP:
+                    static_cast<PolishLoop*>(instruction.element.get())->invalidate_loop_invariants();
+                    break;
+                case FOR_INIT: {
+                    auto end = pop_value(stack);
+                    auto start = pop_value(stack);
+                    loops.push_back(get_for_loop_bounds(start, end, instruction.element->get_position()));
+                    break;
+                }
+                case FOR_NEXT: {
+                    auto& loop = loops.back();
+                    if (loop.first > loop.second) {
+                        loops.pop_back();
+                        pc = instruction.argument;
+                        break;
+                    }
+                    stack.push_back(make_small_integer(loop.first));
+                    loop.first++;
+                    break;
+                }
+                case EVALUATE_ELEMENT:
+                    stack.push_back(instruction.element->handle_wrapper(no_operands, context)->get_object());
+                    break;
+                case EVALUATE_FALLBACK: {
+                    auto fallback = program.fallbacks[instruction.argument];
+                    auto value = iterate_wrapped(fallback, context)->get_object();
+                    while (!fallback.is_empty()) {  // the tree walker takes a definition of a defined function for a call
+                        value = iterate_wrapped(fallback, context)->get_object();
+                    }
+                    stack.push_back(value);
+                    break;
+                }
+            }
+        }
+    } catch (ParsingTypeException& e) {
+        throw EvalException(e.what(), get_instruction_position(code[pc-1]));
+    } catch (DatatypeInternalException& e) {
+        throw EvalException(e.what(), get_instruction_position(code[pc-1]));
+    } catch (SubsetArgumentException& e) {
+        throw EvalException(e.what(), get_instruction_position(code[pc-1]));
+    }
+
+    if (stack.empty()) {
+        return std::make_shared<SymVoidObject>();
+    }
+    return stack.back();
+}
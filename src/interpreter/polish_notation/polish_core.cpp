@@ -34,35 +34,18 @@ class PolishNumber: public PolishNotationElement {
                                     std::shared_ptr<InterpreterContext> &context) {
                                         UNUSED(cmd_list);
                                         UNUSED(context);
-                                        return std::make_shared<SymObjectContainer>(symobject_value->clone());
+                                        return std::make_shared<SymObjectContainer>(symobject_value);
                                     }
 };
 
 class PolishVariable: public PolishNotationElement {
+    UnboundVariableBinding binding;
  public:
      PolishVariable(ParsedCodeElement element): PolishNotationElement(element) { }
      std::shared_ptr<SymObjectContainer> handle_wrapper(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
                                          std::shared_ptr<InterpreterContext> &context) {
          UNUSED(cmd_list);
-
-         // First, try to get a local variable
-         auto existing_var = context->get_variable(get_data());
-         if (existing_var) {
-             if (existing_var->modifiable_in_place()) {
-                 return std::make_shared<SymObjectContainer>(existing_var);
-             }
-             return std::make_shared<SymObjectContainer>(existing_var->clone());
-         }
-
-         // Second, try to get a module constant
-         auto module_constant = context->get_module_constant(get_data());
-         if (module_constant) {
-             return std::make_shared<SymObjectContainer>(module_constant->get_object()->clone());
-         }
-
-         // Third, default to symbolic variable (polynomial)
-         auto res = Polynomial<RationalNumber<BigInt>>::get_atom(BigInt(1), 1);
-         return std::make_shared<SymObjectContainer>(std::make_shared<RationalFunctionType<RationalNumber<BigInt>>>(res));
+         return std::make_shared<SymObjectContainer>(get_variable_value(get_data(), context, binding));
      }
 };
 
@@ -217,6 +200,34 @@ std::shared_ptr<PolishNotationElement> polish_notation_element_from_lexer(const
     throw EvalException("Unknown element type " + element.data, element.position);
 }
 
+const std::shared_ptr<SymObject>& UnboundVariableBinding::resolve(const std::string& name,
+                                                                  const std::shared_ptr<InterpreterContext>& context) {
+    auto& register_in_use = context->get_module_register();
+    if (modules != &register_in_use) {
+        modules = &register_in_use;
+        auto module_constant = register_in_use.find_module_constant(name);
+        if (module_constant) {
+            value = module_constant->get_value()->get_object();
+        } else {
+            auto res = Polynomial<RationalNumber<BigInt>>::get_atom(BigInt(1), 1);
+            value = std::make_shared<RationalFunctionType<RationalNumber<BigInt>>>(res);
+        }
+    }
+    return value;
+}
+
+std::shared_ptr<SymObject> get_variable_value(const std::string& name, std::shared_ptr<InterpreterContext>& context,
+                                              UnboundVariableBinding& binding) {
+    // First, try to get a local variable; values are immutable and hence shared instead of copied
+    auto existing_var = context->get_variable(name);
+    if (existing_var) {
+        return existing_var;
+    }
+
+    // Otherwise a module constant or the formal variable z
+    return binding.resolve(name, context);
+}
+
 std::shared_ptr<SymObjectContainer> iterate_wrapped(LexerDeque<std::shared_ptr<PolishNotationElement>>& cmd_list,
         std::shared_ptr<InterpreterContext> &context) {
     if (cmd_list.is_empty()) {
@@ -227,7 +238,7 @@ std::shared_ptr<SymObjectContainer> iterate_wrapped(LexerDeque<std::shared_ptr<P
     #if DEBUG_EXECUTION
     element->debug_print(std::cout, context);
     #endif
-    context->increment_steps();
+    context->increment_steps(&element->get_base_element().position);
     try {
         return element->handle_wrapper(cmd_list, context);
     } catch (ParsingTypeException& e) {
@@ -0,0 +1,397 @@
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "interpreter/polish_notation/polish_optimizer.hpp"
+#include "interpreter/polish_notation/polish_tree.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/polish_notation/polish_base_math.hpp"
+#include "interpreter/polish_notation/polish_control_flow.hpp"
+#include "interpreter/polish_notation/polish_function_core.hpp"
+#include "interpreter/polish_notation/polish_list.hpp"
+#include "interpreter/polish_notation/polish_optimized.hpp"
+#include "interpreter/polish_notation/polish_utils.hpp"
+#include "interpreter/context.hpp"
+
+typedef LexerDeque<std::shared_ptr<PolishNotationElement>> PolishProgram;
+
+/**
+ * @brief The base element of the root of node, without sub expressions, for the elements replacing node.
+ */
+static ParsedCodeElement get_replacement_base(const PolishNode& node) {
+    auto ret = node.element->get_base_element();
+    ret.sub_expressions = LexerDeque<ParsedCodeElement>();
+    return ret;
+}
+
+static void collect_assigned_variables(const PolishNode& node, std::set<std::string>& assigned) {
+    if (node.kind == ASSIGN_NODE && node.children[0].kind == VARIABLE_NODE) {
+        assigned.insert(node.children[0].element->get_data());
+    } else if (node.kind == FOR_NODE) {
+        assigned.insert(node.children[0].element->get_data());
+    } else if (node.kind == DEFINITION_NODE) {
+        for (uint32_t ind = 0; ind+1 < node.children.size(); ind++) {
+            assigned.insert(node.children[ind].element->get_data());
+        }
+    }
+    for (const auto& child : node.children) {
+        collect_assigned_variables(child, assigned);
+    }
+    for (const auto& statement : node.block) {
+        collect_assigned_variables(statement, assigned);
+    }
+}
+
+static void collect_read_variables(const PolishNode& node, std::set<std::string>& read) {
+    if (node.kind == VARIABLE_NODE) {
+        read.insert(node.element->get_data());
+    }
+    for (const auto& child : node.children) {
+        collect_read_variables(child, read);
+    }
+}
+
+static uint32_t count_nodes(const PolishNode& node) {
+    uint32_t ret = 1;
+    for (const auto& child : node.children) {
+        ret += count_nodes(child);
+    }
+    return ret;
+}
+
+static uint32_t count_variable_uses(const PolishNode& node, const std::string& name) {
+    uint32_t ret = node.kind == VARIABLE_NODE && node.element->get_data() == name ? 1 : 0;
+    for (const auto& child : node.children) {
+        ret += count_variable_uses(child, name);
+    }
+    return ret;
+}
+
+static bool is_leaf(const PolishNode& node) {
+    return node.kind == CONSTANT_NODE || node.kind == VARIABLE_NODE;
+}
+
+/**
+ * @brief Copy of node with the variables in names replaced by the corresponding expressions.
+ */
+static PolishNode substitute_variables(const PolishNode& node, const std::vector<std::string>& names, const std::vector<PolishNode>& expressions) {
+    if (node.kind == VARIABLE_NODE) {
+        for (uint32_t ind = 0; ind < names.size(); ind++) {
+            if (node.element->get_data() == names[ind]) {
+                return expressions[ind];
+            }
+        }
+    }
+    auto ret = node;
+    for (auto& child : ret.children) {
+        child = substitute_variables(child, names, expressions);
+    }
+    return ret;
+}
+
+/**
+ * @brief The loops enclosing an expression, with the variables assigned anywhere inside them.
+ */
+struct EnclosingLoop {
+    std::shared_ptr<PolishLoop> loop;
+    std::set<std::string> assigned;
+};
+
+class PolishOptimizer {
+    std::shared_ptr<InterpreterContext>& context;
+    std::set<std::string> assigned_variables;
+    std::map<std::string, uint32_t> num_definitions;
+    bool parameters_constant;
+
+    void analyze(const PolishNode& node) {
+        if (node.kind == DEFINITION_NODE) {
+            num_definitions[node.element->get_data()]++;
+        }
+        if (std::dynamic_pointer_cast<PolishSetParam>(node.element)) {
+            parameters_constant = false;
+        }
+        for (const auto& child : node.children) {
+            analyze(child);
+        }
+        for (const auto& statement : node.block) {
+            analyze(statement);
+        }
+    }
+
+    /**
+     * @brief Whether calling the module function has no side effects and only depends on its arguments.
+     *
+     * The math and powerseries functions depend on the shell parameters as well, which only stay fixed if the
+     * program does not call setparam.
+     */
+    bool is_pure_module_function(const std::string& name) const {
+        static const std::set<std::string> pure_builtins = {
+            "builtins.eq", "builtins.neq", "builtins.lt", "builtins.lte", "builtins.gt", "builtins.gte",
+            "builtins.and", "builtins.or", "builtins.xor", "builtins.nand", "builtins.nor", "builtins.not"
+        };
+        if (pure_builtins.count(name) > 0) {
+            return true;
+        }
+        if (!parameters_constant || name == "powerseries.solve") {  // solve calls a custom function
+            return false;
+        }
+        return name.rfind("math.", 0) == 0 || name.rfind("powerseries.", 0) == 0;
+    }
+
+    bool is_pure(const PolishNode& node) const {
+        if (is_leaf(node)) {
+            return true;
+        }
+        if (node.kind == MODULE_CALL_NODE && !is_pure_module_function(node.element->get_data())) {
+            return false;
+        }
+        if (node.kind != OPERATOR_NODE && node.kind != MODULE_CALL_NODE) {
+            return false;
+        }
+        for (const auto& child : node.children) {
+            if (!is_pure(child)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Whether a pure expression has the same value wherever and whenever it is evaluated.
+     *
+     * A variable qualifies if the program never assigns it and it is not bound yet; then it evaluates to a module
+     * constant or the formal variable in every scope.
+     */
+    bool is_constant(const PolishNode& node) const {
+        if (node.kind == VARIABLE_NODE) {
+            auto name = node.element->get_data();
+            return assigned_variables.count(name) == 0 && !context->get_variable(name);
+        }
+        if (!is_pure(node)) {
+            return false;
+        }
+        for (const auto& child : node.children) {
+            if (!is_constant(child)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<SymObject> evaluate(const PolishNode& node) {
+        auto expression = serialize_polish_tree({node});
+        try {
+            auto value = iterate_wrapped(expression, context)->get_object();
+            if (expression.is_empty()) {
+                return value;
+            }
+        } catch (std::exception&) {  // reported when the expression is actually executed
+        }
+        return nullptr;
+    }
+
+    bool is_inlinable_definition(const PolishNode& node) const {
+        if (node.kind != DEFINITION_NODE) {
+            return false;
+        }
+        auto name = node.element->get_data();
+        if (num_definitions.at(name) != 1 || context->get_custom_function(name)) {
+            return false;
+        }
+
+        auto& body = node.children.back().block;
+        if (body.size() != 1 || !is_pure(body[0]) || count_nodes(body[0]) > POLISH_INLINE_MAX_SIZE) {
+            return false;
+        }
+
+        auto arguments = std::set<std::string>();
+        for (uint32_t ind = 0; ind+1 < node.children.size(); ind++) {
+            arguments.insert(node.children[ind].element->get_data());
+        }
+        if (arguments.size()+1 != node.children.size()) {
+            return false;
+        }
+
+        // the body must not depend on the scope it is evaluated in
+        auto read = std::set<std::string>();
+        collect_read_variables(body[0], read);
+        for (const auto& variable : read) {
+            if (arguments.count(variable) == 0 && variable.find('.') == std::string::npos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Replaces the call by the body of the definition with the arguments substituted.
+     *
+     * The arguments are evaluated exactly once and in order at runtime. Substitution preserves this up to the order
+     * of pure arguments, so other arguments have to be leaves, which may be evaluated any number of times.
+     */
+    void inline_call(PolishNode& call, const PolishNode& definition) const {
+        auto& body = definition.children.back().block[0];
+        auto names = std::vector<std::string>();
+        for (uint32_t ind = 0; ind+1 < definition.children.size(); ind++) {
+            names.push_back(definition.children[ind].element->get_data());
+        }
+
+        for (uint32_t ind = 0; ind < names.size(); ind++) {
+            auto& argument = call.children[ind];
+            if (!is_leaf(argument) && (count_variable_uses(body, names[ind]) != 1 || !is_pure(argument))) {
+                return;
+            }
+        }
+        call = substitute_variables(body, names, call.children);
+    }
+
+    void inline_calls(PolishNode& node, const PolishNode& definition) const {
+        for (auto& child : node.children) {
+            inline_calls(child, definition);
+        }
+        for (auto& statement : node.block) {
+            inline_calls(statement, definition);
+        }
+
+        if (node.kind == CALL_NODE && node.element->get_data() == definition.element->get_data()
+                && node.children.size()+1 == definition.children.size()) {
+            inline_call(node, definition);
+        }
+    }
+
+    bool hoist_expression(PolishNode& node, std::vector<EnclosingLoop>& loops) const {
+        auto read = std::set<std::string>();
+        collect_read_variables(node, read);
+
+        // the assignments of a loop include those of the loops nested in it, so the outermost suitable loop is first
+        for (auto& enclosing : loops) {
+            bool invariant = true;
+            for (const auto& variable : read) {
+                if (enclosing.assigned.count(variable) > 0) {
+                    invariant = false;
+                    break;
+                }
+            }
+            if (invariant) {
+                auto hoisted = std::make_shared<PolishLoopInvariant>(get_replacement_base(node), serialize_polish_tree({node}),
+                                                                     std::vector<std::string>(read.begin(), read.end()));
+                enclosing.loop->add_loop_invariant(hoisted);
+                node = PolishNode{OTHER_NODE, hoisted, {}, {}};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void hoist_loop(PolishNode& node, std::vector<EnclosingLoop>& loops, uint32_t first_loop_child) const {
+        auto enclosing = EnclosingLoop{std::dynamic_pointer_cast<PolishLoop>(node.element), {}};
+        collect_assigned_variables(node, enclosing.assigned);
+        loops.push_back(enclosing);
+        for (uint32_t ind = first_loop_child; ind < node.children.size(); ind++) {
+            hoist_loop_invariants(node.children[ind], loops);
+        }
+        loops.pop_back();
+    }
+
+ public:
+    PolishOptimizer(std::shared_ptr<InterpreterContext>& context, const std::vector<PolishNode>& program):
+        context(context), parameters_constant(true) {
+        for (const auto& statement : program) {
+            analyze(statement);
+            collect_assigned_variables(statement, assigned_variables);
+        }
+    }
+
+    /**
+     * @brief Inlines the functions defined at the top level of the program into the statements following them.
+     */
+    void inline_functions(std::vector<PolishNode>& program) const {
+        for (uint32_t ind = 0; ind < program.size(); ind++) {
+            if (!is_inlinable_definition(program[ind])) {
+                continue;
+            }
+            for (uint32_t next = ind+1; next < program.size(); next++) {
+                inline_calls(program[next], program[ind]);
+            }
+        }
+    }
+
+    void fold_constants(PolishNode& node) {
+        if (node.kind != CONSTANT_NODE && is_constant(node)) {
+            auto value = evaluate(node);
+            if (value && !value->modifiable_in_place()) {
+                node = PolishNode{CONSTANT_NODE, std::make_shared<PolishConstant>(get_replacement_base(node), value), {}, {}};
+                return;
+            }
+        }
+        for (auto& child : node.children) {
+            fold_constants(child);
+        }
+        for (auto& statement : node.block) {
+            fold_constants(statement);
+        }
+    }
+
+    void hoist_loop_invariants(PolishNode& node, std::vector<EnclosingLoop>& loops) const {
+        switch (node.kind) {
+            case CONSTANT_NODE:
+            case VARIABLE_NODE:
+                return;
+            case FOR_NODE:
+                hoist_loop_invariants(node.children[1], loops);
+                hoist_loop_invariants(node.children[2], loops);
+                hoist_loop(node, loops, 3);
+                return;
+            case WHILE_NODE:
+                hoist_loop(node, loops, 0);
+                return;
+            case DEFINITION_NODE: {
+                auto function_loops = std::vector<EnclosingLoop>();  // the body runs in a scope of its own
+                hoist_loop_invariants(node.children.back(), function_loops);
+                return;
+            }
+            default:
+                break;
+        }
+
+        if (!loops.empty() && is_pure(node) && hoist_expression(node, loops)) {
+            return;
+        }
+        for (auto& child : node.children) {
+            hoist_loop_invariants(child, loops);
+        }
+        for (auto& statement : node.block) {
+            hoist_loop_invariants(statement, loops);
+        }
+    }
+};
+
+PolishProgram optimize_polish_program(const PolishProgram& program, std::shared_ptr<InterpreterContext>& context) {
+    auto& parameters = context->get_shell_parameters();
+    if (!parameters.inline_functions && !parameters.constant_folding && !parameters.hoist_loop_invariants) {
+        return program;
+    }
+
+    try {
+        auto tree = parse_polish_tree(program, true);
+        auto optimizer = PolishOptimizer(context, tree);
+        if (parameters.inline_functions) {
+            optimizer.inline_functions(tree);
+        }
+        if (parameters.constant_folding) {
+            for (auto& statement : tree) {
+                optimizer.fold_constants(statement);
+            }
+        }
+        if (parameters.hoist_loop_invariants) {
+            auto loops = std::vector<EnclosingLoop>();
+            for (auto& statement : tree) {
+                optimizer.hoist_loop_invariants(statement, loops);
+            }
+        }
+        return serialize_polish_tree(tree);
+    } catch (PolishTreeException&) {
+        return program;
+    }
+}
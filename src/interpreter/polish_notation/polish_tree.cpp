@@ -0,0 +1,152 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "interpreter/polish_notation/polish_tree.hpp"
+#include "interpreter/polish_notation/polish.hpp"
+#include "interpreter/polish_notation/polish_control_flow.hpp"
+#include "interpreter/polish_notation/polish_function_core.hpp"
+#include "interpreter/polish_notation/polish_list.hpp"
+#include "interpreter/polish_notation/polish_optimized.hpp"
+
+typedef LexerDeque<std::shared_ptr<PolishNotationElement>> PolishProgram;
+
+static PolishNode parse_node(PolishProgram& program, bool statement);
+
+std::vector<PolishNode> parse_polish_tree(PolishProgram program, bool statements) {
+    auto ret = std::vector<PolishNode>();
+    while (!program.is_empty()) {
+        ret.push_back(parse_node(program, statements));
+    }
+    return ret;
+}
+
+static void parse_children(PolishProgram& program, PolishNode& node, int num_children) {
+    for (int ind = 0; ind < num_children; ind++) {
+        node.children.push_back(parse_node(program, false));
+    }
+}
+
+/**
+ * @brief Whether a custom function element starts a definition; this mirrors PolishCustomFunction, which
+ * decides at runtime, for statements of the form f(x, y) { ... }.
+ */
+static bool is_function_definition(const PolishProgram& program, const std::shared_ptr<PolishNotationElement>& element, bool statement) {
+    if (!statement || element->get_num_expressions() != element->get_num_args()) {
+        return false;
+    }
+    for (int ind = 0; ind < element->get_num_args(); ind++) {
+        auto next = program.peek(ind);
+        if (!next || next.value()->get_type() != VARIABLE) {
+            return false;
+        }
+    }
+    auto scope = program.peek(element->get_num_args());
+    return scope && scope.value()->get_type() == SCOPE_START;
+}
+
+static void expect_kind(const PolishNode& node, PolishNodeKind kind) {
+    if (node.kind != kind) {
+        throw PolishTreeException("Unexpected element " + node.element->get_data());
+    }
+}
+
+static PolishNode parse_node(PolishProgram& program, bool statement) {
+    if (program.is_empty()) {
+        throw PolishTreeException("Unexpected end of program");
+    }
+    auto node = PolishNode{OTHER_NODE, program.front(), {}, {}};
+    program.pop_front();
+    auto& element = node.element;
+
+    if (std::dynamic_pointer_cast<PolishConstant>(element)) {
+        node.kind = CONSTANT_NODE;
+    } else if (std::dynamic_pointer_cast<PolishLoopInvariant>(element)) {
+        // an expression hoisted by the optimisation pass; it carries the expression as sub expressions
+    } else if (std::dynamic_pointer_cast<PolishModuleFunction>(element)) {
+        node.kind = MODULE_CALL_NODE;
+        parse_children(program, node, element->get_num_args());
+    } else if (std::dynamic_pointer_cast<PolishFor>(element)) {
+        node.kind = FOR_NODE;
+        parse_children(program, node, 4);
+        expect_kind(node.children[0], VARIABLE_NODE);
+        expect_kind(node.children[3], SCOPE_NODE);
+    } else if (std::dynamic_pointer_cast<PolishWhile>(element)) {
+        node.kind = WHILE_NODE;
+        parse_children(program, node, 2);
+        expect_kind(node.children[1], SCOPE_NODE);
+    } else if (std::dynamic_pointer_cast<PolishIf>(element)) {
+        node.kind = IF_NODE;
+        parse_children(program, node, 2);
+        expect_kind(node.children[1], SCOPE_NODE);
+        auto next = program.peek();
+        if (next && next.value()->get_data() == "elif") {
+            parse_children(program, node, 1);
+        }
+    } else if (std::dynamic_pointer_cast<PolishCustomFunction>(element)) {
+        if (is_function_definition(program, element, statement)) {
+            node.kind = DEFINITION_NODE;
+            parse_children(program, node, element->get_num_args()+1);
+        } else {
+            node.kind = CALL_NODE;
+            parse_children(program, node, element->get_num_args());
+        }
+    } else if (std::dynamic_pointer_cast<PolishArrayAccess>(element)) {
+        node.kind = SUBSCRIPT_NODE;
+        parse_children(program, node, 1);
+        node.block = parse_polish_tree(element->get_sub_expressions(), false);
+    } else if (std::dynamic_pointer_cast<PolishFunction>(element)) {
+        parse_children(program, node, element->get_num_args());
+    } else {
+        switch (element->get_type()) {
+            case NUMBER:
+            case STRING:
+                node.kind = CONSTANT_NODE;
+                break;
+            case VARIABLE:
+                node.kind = VARIABLE_NODE;
+                break;
+            case SCOPE_START:
+                node.kind = SCOPE_NODE;
+                node.block = parse_polish_tree(element->get_sub_expressions(), true);
+                break;
+            case INFIX_PLUS:
+            case INFIX_MINUS:
+            case INFIX_MULTIPLY:
+            case INFIX_DIVIDE:
+            case INFIX_POWER:
+                node.kind = OPERATOR_NODE;
+                parse_children(program, node, 2);
+                break;
+            case UNARY_MINUS:
+            case UNARY_PLUS:
+                node.kind = OPERATOR_NODE;
+                parse_children(program, node, 1);
+                break;
+            case INFIX_ASSIGN:
+                node.kind = ASSIGN_NODE;
+                parse_children(program, node, 2);
+                break;
+            default:
+                throw PolishTreeException("Unexpected element " + element->get_data());
+        }
+    }
+    return node;
+}
+
+static void serialize_node(const PolishNode& node, std::vector<std::shared_ptr<PolishNotationElement>>& output) {
+    if (node.kind == SCOPE_NODE || node.kind == SUBSCRIPT_NODE) {
+        node.element->set_sub_expressions(serialize_polish_tree(node.block));
+    }
+    output.push_back(node.element);
+    for (const auto& child : node.children) {
+        serialize_node(child, output);
+    }
+}
+
+PolishProgram serialize_polish_tree(const std::vector<PolishNode>& block) {
+    auto elements = std::vector<std::shared_ptr<PolishNotationElement>>();
+    for (const auto& node : block) {
+        serialize_node(node, elements);
+    }
+    return PolishProgram(std::move(elements));
+}
@@ -0,0 +1,167 @@
+#include <sys/time.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <utility>
+#include "interpreter/profiler.hpp"
+#include "cpp_utils/unused.hpp"
+
+volatile sig_atomic_t profiler_sample_due = 0;
+
+static const std::string toplevel_name = "<toplevel>";
+
+static void handle_profiler_signal(int signal) {
+    UNUSED(signal);
+    profiler_sample_due = 1;
+}
+
+static std::vector<uint32_t> get_line_starts(const std::string& content) {
+    auto starts = std::vector<uint32_t>{0};
+    for (uint32_t ind = 0; ind < content.size(); ind++) {
+        if (content[ind] == '\n') {
+            starts.push_back(ind+1);
+        }
+    }
+    return starts;
+}
+
+void SourceLines::set_source(const std::string& file_name, const std::string& content) {
+    line_starts[file_name] = get_line_starts(content);
+}
+
+std::string SourceLines::get_label(const CodePlaceIdentifier& position, const std::shared_ptr<ContextInterface>& context) {
+    auto file_name = position.get_file_name();
+    auto label = file_name.empty() ? std::string("<input>") : file_name;
+    if (!context->has_file_navigator(file_name)) {
+        return label;
+    }
+
+    auto it = line_starts.find(file_name);
+    if (it == line_starts.end()) {
+        std::ifstream file(file_name);
+        auto starts = std::vector<uint32_t>();
+        if (file.is_open()) {
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            starts = get_line_starts(buffer.str());
+        }
+        it = line_starts.emplace(file_name, std::move(starts)).first;
+    }
+    auto& starts = it->second;
+    if (starts.empty()) {
+        return label;
+    }
+    auto offset = position.get_original_position(context);
+    auto line = std::upper_bound(starts.begin(), starts.end(), offset)-starts.begin();
+    return label+":"+std::to_string(line);
+}
+
+SamplingProfiler::SamplingProfiler() : last_sample_steps(0), running(false) { }
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+void SamplingProfiler::start(uint64_t steps) {
+    // The handler stays installed after stopping, as a signal may still be pending then
+    struct sigaction action = {};
+    action.sa_handler = handle_profiler_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+
+    struct itimerval timer = {};
+    timer.it_interval.tv_usec = PROFILER_SAMPLE_INTERVAL_US;
+    timer.it_value.tv_usec = PROFILER_SAMPLE_INTERVAL_US;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    last_sample = std::chrono::steady_clock::now();
+    last_sample_steps = steps;
+    running = true;
+}
+
+void SamplingProfiler::stop() {
+    if (!running) {
+        return;
+    }
+    struct itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    profiler_sample_due = 0;
+    running = false;
+}
+
+void SamplingProfiler::record_sample(const CodePlaceIdentifier* position, uint64_t steps, const std::shared_ptr<ContextInterface>& context) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now-last_sample).count();
+    uint64_t elapsed_steps = steps-last_sample_steps;
+    last_sample = now;
+    last_sample_steps = steps;
+
+    // level 0 is the top level, level ind > 0 the call frames[ind-1] made from level ind-1
+    std::string stack;
+    std::string innermost_line;
+    std::set<std::string> seen_functions;
+    std::set<std::string> seen_lines;
+    for (size_t level = 0; level <= frames.size(); level++) {
+        auto& name = level == 0 ? toplevel_name : *frames[level-1].name;
+        auto label = name;
+        if (level == 0 || frames[level-1].has_source) {
+            auto executed = level < frames.size() ? frames[level].call_site : position;
+            if (executed) {
+                auto line = sources.get_label(*executed, context);
+                label += " ("+line+")";
+                innermost_line = line;
+                if (seen_lines.insert(line).second) {
+                    lines[line].inclusive.add(elapsed, elapsed_steps);
+                }
+            }
+        }
+        if (seen_functions.insert(name).second) {
+            functions[name].inclusive.add(elapsed, elapsed_steps);
+        }
+        if (level > 0) {
+            stack += ';';
+        }
+        stack += label;
+    }
+
+    functions[frames.empty() ? toplevel_name : *frames.back().name].exclusive.add(elapsed, elapsed_steps);
+    if (!innermost_line.empty()) {
+        lines[innermost_line].exclusive.add(elapsed, elapsed_steps);
+    }
+    stacks[stack].add(elapsed, elapsed_steps);
+}
+
+void SamplingProfiler::write_collapsed_stacks(std::ostream& stream) const {
+    for (const auto& [stack, counts] : stacks) {
+        stream << stack << " " << counts.microseconds << std::endl;
+    }
+}
+
+static void write_profile_table(std::ostream& stream, const std::string& title, const std::map<std::string, ProfileEntry>& entries,
+                                size_t max_entries) {
+    auto sorted = std::vector<std::pair<std::string, ProfileEntry>>(entries.begin(), entries.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.exclusive.microseconds > b.second.exclusive.microseconds;
+    });
+    if (sorted.size() > max_entries) {
+        sorted.resize(max_entries);
+    }
+
+    stream << std::left << std::setw(40) << title << std::right << std::setw(12) << "excl. ms" << std::setw(12) << "incl. ms"
+           << std::setw(16) << "excl. steps" << std::setw(16) << "incl. steps" << std::endl;
+    stream << std::fixed << std::setprecision(1);
+    for (const auto& [name, entry] : sorted) {
+        stream << std::left << std::setw(40) << name << std::right
+               << std::setw(12) << entry.exclusive.microseconds/1000.0 << std::setw(12) << entry.inclusive.microseconds/1000.0
+               << std::setw(16) << entry.exclusive.steps << std::setw(16) << entry.inclusive.steps << std::endl;
+    }
+    stream << std::defaultfloat;
+}
+
+void SamplingProfiler::write_report(std::ostream& stream, size_t max_entries) const {
+    write_profile_table(stream, "Function", functions, max_entries);
+    write_profile_table(stream, "Line", lines, max_entries);
+}
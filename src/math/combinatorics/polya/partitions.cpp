@@ -9,6 +9,12 @@
 #include <stdint.h>
 #include <functional>
 #include <iostream>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "math/combinatorics/polya/partitions.hpp"
 
 
@@ -84,3 +90,81 @@ void iterate_partitions(const uint32_t size, std::function<void(std::vector<Part
     storage.reserve(size);
     iterate_partitions_internal(size, size, storage, callback);
 }
+
+/**
+ * @brief Iterates over partitions of a given size on several threads.
+ *
+ * Every partition of size > 0 is uniquely determined by its prefix (largest part, multiplicity of the largest part)
+ * and a partition of the remainder into strictly smaller parts. The prefixes are the tasks which are
+ * picked up by the workers via a shared atomic counter; this balances the very uneven task sizes.
+ *
+ * @param size The size of the partitions we want to generate.
+ * @param num_threads The number of worker threads.
+ * @param callback The function to apply to each partition and the index of the calling thread.
+ */
+void iterate_partitions_parallel(const uint32_t size,
+                                 const uint32_t num_threads,
+                                 std::function<void(std::vector<PartitionCount>&, const uint32_t)> callback) {
+    if (size == 0 || num_threads < 2) {
+        std::function<void(std::vector<PartitionCount>&)> single_threaded = [&callback](std::vector<PartitionCount>& partition) {
+            callback(partition, 0);
+        };
+        iterate_partitions(size, single_threaded);
+        return;
+    }
+
+    auto prefixes = std::vector<PartitionCount>();
+    for (uint32_t max_value = size; max_value >= 1; max_value--) {
+        for (uint32_t cnt = 1; cnt <= size/max_value; cnt++) {
+            if (max_value == 1 && cnt != size) {
+                continue;
+            }
+            prefixes.push_back(PartitionCount(max_value, cnt));
+        }
+    }
+
+    std::atomic<size_t> next_task(0);
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&](const uint32_t thread_index) {
+        std::function<void(std::vector<PartitionCount>&)> local_callback = [&callback, thread_index](std::vector<PartitionCount>& partition) {
+            callback(partition, thread_index);
+        };
+        auto storage = std::vector<PartitionCount>();
+        storage.reserve(size);
+
+        try {
+            for (auto task = next_task++; task < prefixes.size(); task = next_task++) {
+                auto prefix = prefixes[task];
+                auto remaining = size-prefix.num*prefix.count;
+                storage.push_back(prefix);
+                if (remaining == 0) {
+                    local_callback(storage);
+                } else {
+                    iterate_partitions_internal(remaining, prefix.num-1, storage, local_callback);
+                }
+                storage.pop_back();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next_task = prefixes.size();
+        }
+    };
+
+    auto threads = std::vector<std::thread>();
+    for (uint32_t thread_index = 0; thread_index < num_threads; thread_index++) {
+        threads.push_back(std::thread(worker, thread_index));
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
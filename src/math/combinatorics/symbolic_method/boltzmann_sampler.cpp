@@ -0,0 +1,787 @@
+/**
+ * @file boltzmann_sampler.cpp
+ * @brief Boltzmann samplers for specifications built from the symbolic method operators.
+ */
+
+#include "math/combinatorics/symbolic_method/boltzmann_sampler.hpp"
+#include <stdint.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "math/number_theory/euler_phi.hpp"
+
+#define BOLTZMANN_NEGLIGIBLE 1e-17  // relative size of a term from which on the remaining terms are dropped
+#define BOLTZMANN_TUNING_STEPS 80
+
+static const double infinity = std::numeric_limits<double>::infinity();
+
+/**
+ * @brief Uniform random number in (0, 1].
+ */
+static double uniform(std::mt19937_64& rng) {
+    return (static_cast<double>(rng() >> 11)+1.0)*0x1.0p-53;
+}
+
+/**
+ * @brief Poisson distributed random number, by inversion; large parameters are split up to avoid underflow.
+ */
+static uint32_t draw_poisson(std::mt19937_64& rng, double lambda) {
+    uint32_t ret = 0;
+    while (lambda > 500) {
+        ret += draw_poisson(rng, 500);
+        lambda -= 500;
+    }
+
+    auto p = std::exp(-lambda);
+    auto u = uniform(rng);
+    auto cumulative = p;
+    while (u > cumulative && p > 0) {
+        ret++;
+        p = p*lambda/ret;
+        cumulative += p;
+    }
+    return ret;
+}
+
+/**
+ * @brief Poisson distributed random number conditioned on being at least 1.
+ */
+static uint32_t draw_positive_poisson(std::mt19937_64& rng, const double lambda) {
+    if (lambda > 1) {
+        while (true) {
+            auto ret = draw_poisson(rng, lambda);
+            if (ret > 0) {
+                return ret;
+            }
+        }
+    }
+
+    auto p = lambda/std::expm1(lambda);
+    auto u = uniform(rng);
+    auto cumulative = p;
+    uint32_t ret = 1;
+    while (u > cumulative && p > 0) {
+        ret++;
+        p = p*lambda/ret;
+        cumulative += p;
+    }
+    return ret;
+}
+
+/**
+ * @brief Geometric random number with P(k) = (1-a)*a^k.
+ */
+static uint32_t draw_geometric(std::mt19937_64& rng, const double a) {
+    if (a <= 0) {
+        return 0;
+    }
+    auto ret = std::floor(std::log(uniform(rng))/std::log(a));
+    return ret > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(ret);
+}
+
+/**
+ * @brief Logarithmic random number with P(k) = a^k/(k*log(1/(1-a))), k >= 1.
+ */
+static uint32_t draw_logarithmic(std::mt19937_64& rng, const double a) {
+    auto u = uniform(rng)*(-std::log1p(-a));
+    uint32_t ret = 1;
+    auto power = a;
+    auto cumulative = a;
+    while (u > cumulative && power > 0) {
+        ret++;
+        power = power*a;
+        cumulative += power/ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief Index of the entry in which u falls for the given prefix sums.
+ */
+static uint32_t draw_from_prefix_sums(const std::vector<double>& prefix_sums, const double u) {
+    auto it = std::lower_bound(prefix_sums.begin(), prefix_sums.end(), u);
+    if (it == prefix_sums.end()) {
+        return prefix_sums.size()-1;
+    }
+    return it-prefix_sums.begin();
+}
+
+static void skip_spaces(const std::string& spec, size_t& pos) {
+    while (pos < spec.size() && std::isspace(static_cast<unsigned char>(spec[pos]))) {
+        pos++;
+    }
+}
+
+BoltzmannSampler::BoltzmannSampler(const std::string& specification, const bool labelled, const uint32_t min_size, const uint32_t max_size):
+    labelled(labelled), min_size(min_size), max_size(max_size), parameter(0) {
+    if (min_size > max_size) {
+        throw std::runtime_error("Boltzmann sampler: minimal size larger than maximal size");
+    }
+
+    size_t pos = 0;
+    root = parse(specification, pos);
+    skip_spaces(specification, pos);
+    if (pos != specification.size()) {
+        throw std::runtime_error("Boltzmann sampler: unexpected symbol at position "+std::to_string(pos)+" in "+specification);
+    }
+
+    calculate_min_sizes();
+    phi = calculate_euler_phi(max_size+1);
+    tune();
+}
+
+uint32_t BoltzmannSampler::parse(const std::string& spec, size_t& pos) {
+    auto summands = std::vector<uint32_t>({parse_product(spec, pos)});
+    skip_spaces(spec, pos);
+    while (pos < spec.size() && spec[pos] == '+') {
+        pos++;
+        summands.push_back(parse_product(spec, pos));
+        skip_spaces(spec, pos);
+    }
+
+    if (summands.size() == 1) {
+        return summands[0];
+    }
+    nodes.push_back(BoltzmannSpecNode(BoltzmannNodeType::UNION, Subset("", max_size+1), false));
+    nodes.back().children = summands;
+    return nodes.size()-1;
+}
+
+uint32_t BoltzmannSampler::parse_product(const std::string& spec, size_t& pos) {
+    auto factors = std::vector<uint32_t>({parse_factor(spec, pos)});
+    skip_spaces(spec, pos);
+    while (pos < spec.size() && spec[pos] == '*') {
+        pos++;
+        factors.push_back(parse_factor(spec, pos));
+        skip_spaces(spec, pos);
+    }
+
+    if (factors.size() == 1) {
+        return factors[0];
+    }
+    nodes.push_back(BoltzmannSpecNode(BoltzmannNodeType::PRODUCT, Subset("", max_size+1), false));
+    nodes.back().children = factors;
+    return nodes.size()-1;
+}
+
+uint32_t BoltzmannSampler::parse_factor(const std::string& spec, size_t& pos) {
+    skip_spaces(spec, pos);
+    if (pos >= spec.size()) {
+        throw std::runtime_error("Boltzmann sampler: unexpected end of specification "+spec);
+    }
+
+    if (spec[pos] == '(') {
+        pos++;
+        auto ret = parse(spec, pos);
+        skip_spaces(spec, pos);
+        if (pos >= spec.size() || spec[pos] != ')') {
+            throw std::runtime_error("Boltzmann sampler: missing closing bracket in "+spec);
+        }
+        pos++;
+        return ret;
+    }
+
+    auto start = pos;
+    while (pos < spec.size() && std::isalnum(static_cast<unsigned char>(spec[pos]))) {
+        pos++;
+    }
+    auto name = spec.substr(start, pos-start);
+
+    if (name == "Z" || name == "z" || name == "1" || name == "T") {
+        auto type = BoltzmannNodeType::ATOM;
+        if (name == "1") {
+            type = BoltzmannNodeType::EPSILON;
+        } else if (name == "T") {
+            type = BoltzmannNodeType::RECURSION;
+        }
+        nodes.push_back(BoltzmannSpecNode(type, Subset("", max_size+1), false));
+        return nodes.size()-1;
+    }
+
+    auto operators = std::map<std::string, BoltzmannNodeType>({
+        {"SEQ", BoltzmannNodeType::SEQ},
+        {"MSET", BoltzmannNodeType::MSET},
+        {"CYC", BoltzmannNodeType::CYC},
+        {"LSET", BoltzmannNodeType::LSET},
+        {"LCYC", BoltzmannNodeType::LCYC},
+    });
+    auto it = operators.find(name);
+    if (it == operators.end()) {
+        throw std::runtime_error("Boltzmann sampler: unknown symbol \""+name+"\" in "+spec);
+    }
+    auto type = it->second;
+
+    if (labelled && (type == BoltzmannNodeType::MSET || type == BoltzmannNodeType::CYC)) {
+        throw std::runtime_error("Boltzmann sampler: "+name+" is not allowed in labelled specifications");
+    }
+    if (!labelled && (type == BoltzmannNodeType::LSET || type == BoltzmannNodeType::LCYC)) {
+        throw std::runtime_error("Boltzmann sampler: "+name+" is not allowed in unlabelled specifications");
+    }
+
+    skip_spaces(spec, pos);
+    if (pos >= spec.size() || spec[pos] != '(') {
+        throw std::runtime_error("Boltzmann sampler: expected ( after "+name);
+    }
+    pos++;
+    auto child = parse(spec, pos);
+    skip_spaces(spec, pos);
+
+    std::string restriction = "";
+    if (pos < spec.size() && spec[pos] == ',') {
+        pos++;
+        auto restriction_start = pos;
+        while (pos < spec.size() && spec[pos] != ')') {
+            pos++;
+        }
+        restriction = spec.substr(restriction_start, pos-restriction_start);
+        restriction.erase(std::remove_if(restriction.begin(), restriction.end(), [](unsigned char c) { return std::isspace(c); }), restriction.end());
+        if (type == BoltzmannNodeType::MSET || type == BoltzmannNodeType::CYC) {
+            throw std::runtime_error("Boltzmann sampler: restricted "+name+" is not supported");
+        }
+    }
+
+    if (pos >= spec.size() || spec[pos] != ')') {
+        throw std::runtime_error("Boltzmann sampler: missing closing bracket after "+name);
+    }
+    pos++;
+
+    nodes.push_back(BoltzmannSpecNode(type, Subset(restriction, max_size+1), restriction != ""));
+    nodes.back().children.push_back(child);
+    return nodes.size()-1;
+}
+
+/**
+ * @brief Calculates the minimal object size of every node as a fixed point, and checks that the specification is well founded.
+ */
+void BoltzmannSampler::calculate_min_sizes() {
+    const uint32_t unreachable = UINT32_MAX;
+    for (auto& node : nodes) {
+        node.min_size = unreachable;
+    }
+
+    auto saturating_add = [unreachable](uint64_t a, uint64_t b) {
+        return static_cast<uint32_t>(std::min(a+b, static_cast<uint64_t>(unreachable)));
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& node : nodes) {
+            uint32_t new_size = unreachable;
+            switch (node.type) {
+                case BoltzmannNodeType::ATOM:
+                    new_size = 1;
+                    break;
+                case BoltzmannNodeType::EPSILON:
+                case BoltzmannNodeType::MSET:
+                    new_size = 0;
+                    break;
+                case BoltzmannNodeType::RECURSION:
+                    new_size = nodes[root].min_size;
+                    break;
+                case BoltzmannNodeType::UNION:
+                    for (auto child : node.children) {
+                        new_size = std::min(new_size, nodes[child].min_size);
+                    }
+                    break;
+                case BoltzmannNodeType::PRODUCT:
+                    new_size = 0;
+                    for (auto child : node.children) {
+                        new_size = saturating_add(new_size, nodes[child].min_size);
+                    }
+                    break;
+                case BoltzmannNodeType::CYC:
+                    new_size = nodes[node.children[0]].min_size;
+                    break;
+                case BoltzmannNodeType::SEQ:
+                case BoltzmannNodeType::LSET:
+                case BoltzmannNodeType::LCYC: {
+                    uint32_t min_count = node.type == BoltzmannNodeType::LCYC ? 1 : 0;
+                    while (min_count <= max_size && (node.subset.indices.count(min_count) > 0) == node.subset.negate) {
+                        min_count++;
+                    }
+                    auto child_size = nodes[node.children[0]].min_size;
+                    if (min_count > max_size) {
+                        new_size = unreachable;
+                    } else if (min_count == 0) {
+                        new_size = 0;
+                    } else {
+                        new_size = std::min(static_cast<uint64_t>(child_size)*min_count, static_cast<uint64_t>(unreachable));
+                    }
+                    break;
+                }
+            }
+            if (new_size < node.min_size) {
+                node.min_size = new_size;
+                changed = true;
+            }
+        }
+    }
+
+    if (nodes[root].min_size == unreachable) {
+        throw std::runtime_error("Boltzmann sampler: the specification does not contain any objects");
+    }
+
+    for (auto& node : nodes) {
+        if (node.type >= BoltzmannNodeType::SEQ && nodes[node.children[0]].min_size == 0) {
+            throw std::runtime_error("Boltzmann sampler: components of SEQ, MSET, CYC, LSET and LCYC must not be empty");
+        }
+    }
+}
+
+void BoltzmannSampler::set_parameter(const double x) {
+    parameter = x;
+    values.assign(nodes.size(), std::vector<double>());
+    recursion_values.clear();
+    cumulative_weights.clear();
+}
+
+/**
+ * @brief log(exp(a)+exp(b)), also for infinite arguments.
+ */
+static double log_add(const double a, const double b) {
+    if (a == -infinity || b == infinity) {
+        return b;
+    }
+    if (b == -infinity || a == infinity) {
+        return a;
+    }
+    return std::max(a, b)+std::log1p(std::exp(-std::abs(a-b)));
+}
+
+/**
+ * @brief Logarithms of the terms making up the value of a restricted SEQ/LSET/LCYC (indexed by number of components)
+ * or an MSET/CYC (index i-1 for the i-th Polya term, for MSET these are the Poisson parameters lambda_i).
+ *
+ * Terms that only contribute objects larger than max_size and terms that are negligible are dropped;
+ * sampling uses exactly the same terms.
+ */
+std::vector<double> BoltzmannSampler::component_weights(const uint32_t node, const uint32_t level, const double* recursion_value) {
+    auto& spec = nodes[node];
+    auto child = spec.children[0];
+    uint64_t max_count = max_size/(static_cast<uint64_t>(level)*nodes[child].min_size);
+    auto ret = std::vector<double>();
+    const double negligible = std::log(BOLTZMANN_NEGLIGIBLE);
+
+    if (spec.type == BoltzmannNodeType::MSET || spec.type == BoltzmannNodeType::CYC) {
+        double sum = -infinity;
+        for (uint64_t i = 1; i <= max_count; i++) {
+            auto log_a = evaluate(child, level*i, i == 1 ? recursion_value : nullptr);
+            double term;
+            if (spec.type == BoltzmannNodeType::MSET) {
+                term = log_a-std::log(i);
+            } else {
+                auto a = std::exp(log_a);
+                term = a < 1 ? std::log(-std::log1p(-a)*phi[i]/i) : infinity;
+            }
+            ret.push_back(term);
+            sum = log_add(sum, term);
+            if (sum == infinity || (i > 1 && term < negligible+sum)) {
+                break;
+            }
+        }
+        return ret;
+    }
+
+    auto log_a = evaluate(child, level, recursion_value);
+    double term = 0;
+    double previous = -infinity;
+    double sum = -infinity;
+    for (uint64_t j = 0; j <= max_count; j++) {
+        if (j > 0) {
+            term = term+log_a;
+            if (spec.type == BoltzmannNodeType::LSET) {
+                term = term-std::log(j);
+            }
+        }
+        auto weight = term;
+        if (spec.type == BoltzmannNodeType::LCYC) {
+            weight = j == 0 ? -infinity : term-std::log(j);
+        }
+        bool included = j < spec.subset.exclusive_max && (spec.subset.indices.count(j) > 0) != spec.subset.negate;
+        ret.push_back(included ? weight : -infinity);
+        sum = log_add(sum, ret.back());
+        if (sum == infinity || (weight < previous && weight < negligible+sum)) {
+            break;
+        }
+        previous = weight;
+    }
+    return ret;
+}
+
+/**
+ * @brief Evaluates the logarithm of the generating function of a node at x^level; logarithms avoid overflows for entire functions.
+ *
+ * @param recursion_value If not null, the logarithm of the value used for T at this level (while solving for it); results are not cached then.
+ */
+double BoltzmannSampler::evaluate(const uint32_t node, const uint32_t level, const double* recursion_value) {
+    if (recursion_value == nullptr && level < values[node].size() && !std::isnan(values[node][level])) {
+        return values[node][level];
+    }
+
+    auto& spec = nodes[node];
+    double ret = 0;
+    switch (spec.type) {
+        case BoltzmannNodeType::ATOM:
+            ret = level*std::log(parameter);
+            break;
+        case BoltzmannNodeType::EPSILON:
+            ret = 0;
+            break;
+        case BoltzmannNodeType::RECURSION:
+            ret = recursion_value != nullptr ? *recursion_value : std::log(solve_recursion(level));
+            break;
+        case BoltzmannNodeType::UNION:
+            ret = -infinity;
+            for (auto child : spec.children) {
+                ret = log_add(ret, evaluate(child, level, recursion_value));
+            }
+            break;
+        case BoltzmannNodeType::PRODUCT:
+            for (auto child : spec.children) {
+                ret += evaluate(child, level, recursion_value);
+            }
+            break;
+        case BoltzmannNodeType::SEQ:
+        case BoltzmannNodeType::LSET:
+        case BoltzmannNodeType::LCYC:
+            if (!spec.restricted) {
+                auto a = std::exp(evaluate(spec.children[0], level, recursion_value));
+                if (spec.type == BoltzmannNodeType::SEQ) {
+                    ret = a < 1 ? -std::log1p(-a) : infinity;
+                } else if (spec.type == BoltzmannNodeType::LSET) {
+                    ret = a;
+                } else {
+                    ret = a < 1 ? std::log(-std::log1p(-a)) : infinity;
+                }
+                break;
+            }
+            [[fallthrough]];
+        case BoltzmannNodeType::MSET:
+        case BoltzmannNodeType::CYC: {
+            auto terms = component_weights(node, level, recursion_value);
+            if (spec.type == BoltzmannNodeType::MSET) {
+                for (auto term : terms) {
+                    ret += std::exp(term);
+                }
+            } else {
+                ret = -infinity;
+                for (auto term : terms) {
+                    ret = log_add(ret, term);
+                }
+            }
+            break;
+        }
+    }
+
+    if (std::isnan(ret)) {
+        ret = infinity;
+    }
+
+    if (recursion_value == nullptr) {
+        if (values[node].size() <= level) {
+            values[node].resize(level+1, std::numeric_limits<double>::quiet_NaN());
+        }
+        values[node][level] = ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief Solves T(x^level) = F(T)(x^level) by Newton iteration from 0, which converges monotonically to the smallest solution since F is convex.
+ *
+ * @return The value, infinity if there is no solution (x beyond the singularity).
+ */
+double BoltzmannSampler::solve_recursion(const uint32_t level) {
+    if (level < recursion_values.size() && !std::isnan(recursion_values[level])) {
+        return recursion_values[level];
+    }
+
+    double y = 0;
+    for (uint32_t iteration = 0; iteration < 1000; iteration++) {
+        auto log_y = std::log(y);
+        auto value = std::exp(evaluate(root, level, &log_y));
+        if (!std::isfinite(value)) {
+            y = infinity;
+            break;
+        }
+        auto step = 1e-7*(1+y);
+        auto log_shifted = std::log(y+step);
+        auto derivative = (std::exp(evaluate(root, level, &log_shifted))-value)/step;
+        if (!(derivative < 1)) {
+            y = infinity;
+            break;
+        }
+        auto next = y+(value-y)/(1-derivative);
+        if (std::abs(next-y) <= 1e-15*next) {
+            y = next;
+            break;
+        }
+        y = next;
+    }
+
+    if (recursion_values.size() <= level) {
+        recursion_values.resize(level+1, std::numeric_limits<double>::quiet_NaN());
+    }
+    recursion_values[level] = y;
+    return y;
+}
+
+/**
+ * @brief Cached prefix sums of the component weights of a node, for sampling.
+ *
+ * For MSET these are the prefix sums of the lambda_i, for all other operators the weights are only relative.
+ */
+const std::vector<double>& BoltzmannSampler::get_weights(const uint32_t node, const uint32_t level) {
+    auto key = std::make_pair(node, level);
+    auto it = cumulative_weights.find(key);
+    if (it != cumulative_weights.end()) {
+        return it->second;
+    }
+
+    auto weights = component_weights(node, level, nullptr);
+    double offset = 0;
+    if (nodes[node].type != BoltzmannNodeType::MSET && !weights.empty()) {
+        offset = *std::max_element(weights.begin(), weights.end());
+    }
+    for (size_t ind = 0; ind < weights.size(); ind++) {
+        weights[ind] = std::exp(weights[ind]-offset)+(ind > 0 ? weights[ind-1] : 0);
+    }
+    return cumulative_weights.emplace(key, std::move(weights)).first->second;
+}
+
+/**
+ * @brief Expected size x*F'(x)/F(x) of the Boltzmann distribution, infinity if x is beyond the singularity.
+ */
+double BoltzmannSampler::expected_size(const double x) {
+    const double step = 1e-5;
+    set_parameter(x*std::exp(-step));
+    auto lower = evaluate(root, 1, nullptr);
+    set_parameter(x*std::exp(step));
+    auto upper = evaluate(root, 1, nullptr);
+    if (!std::isfinite(lower) || !std::isfinite(upper)) {
+        return infinity;
+    }
+    return (upper-lower)/(2*step);
+}
+
+/**
+ * @brief Chooses x such that the expected size is the middle of the target window, by bisection on log(x).
+ */
+void BoltzmannSampler::tune() {
+    auto target = (static_cast<double>(min_size)+max_size)/2;
+    double lower = -50;
+    double upper = 50;
+    for (uint32_t step = 0; step < BOLTZMANN_TUNING_STEPS; step++) {
+        auto middle = (lower+upper)/2;
+        if (expected_size(std::exp(middle)) < target) {
+            lower = middle;
+        } else {
+            upper = middle;
+        }
+    }
+
+    set_parameter(std::exp(lower));
+    if (!std::isfinite(evaluate(root, 1, nullptr))) {
+        throw std::runtime_error("Boltzmann sampler: tuning the parameter failed");
+    }
+}
+
+uint32_t BoltzmannSampler::copy_subtree(BoltzmannObject& obj, const uint32_t source) {
+    auto ret = static_cast<uint32_t>(obj.nodes.size());
+    obj.nodes.push_back(BoltzmannObject::Node{0, {}});
+    auto stack = std::vector<std::pair<uint32_t, uint32_t>>({{source, ret}});
+
+    while (!stack.empty()) {
+        auto [from, to] = stack.back();
+        stack.pop_back();
+        if (obj.nodes[from].label != 0) {
+            obj.size++;
+            obj.nodes[to].label = obj.size;
+            continue;
+        }
+        for (size_t ind = 0; ind < obj.nodes[from].children.size(); ind++) {
+            auto copy = static_cast<uint32_t>(obj.nodes.size());
+            obj.nodes.push_back(BoltzmannObject::Node{0, {}});
+            obj.nodes[to].children.push_back(copy);
+            stack.push_back({obj.nodes[from].children[ind], copy});
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Draws a single object, iteratively to allow deep objects; aborts as soon as the size exceeds max_size.
+ */
+bool BoltzmannSampler::sample_once(std::mt19937_64& rng, BoltzmannObject& ret) {
+    ret.nodes.clear();
+    ret.nodes.push_back(BoltzmannObject::Node{0, {}});
+    ret.size = 0;
+
+    auto new_list = [&ret](const uint32_t parent) {
+        auto index = static_cast<uint32_t>(ret.nodes.size());
+        ret.nodes.push_back(BoltzmannObject::Node{0, {}});
+        ret.nodes[parent].children.push_back(index);
+        return index;
+    };
+
+    auto tasks = std::vector<Task>({Task{root, 1, 0, 0, 0}});
+    while (!tasks.empty()) {
+        auto task = tasks.back();
+        tasks.pop_back();
+
+        if (task.copies > 0) {
+            auto num_children = ret.nodes[task.parent].children.size();
+            for (uint32_t copy = 0; copy < task.copies; copy++) {
+                for (size_t ind = num_children-task.block_size; ind < num_children; ind++) {
+                    auto copied = copy_subtree(ret, ret.nodes[task.parent].children[ind]);
+                    ret.nodes[task.parent].children.push_back(copied);
+                    if (ret.size > max_size) {
+                        return false;
+                    }
+                }
+            }
+            continue;
+        }
+
+        auto& spec = nodes[task.node];
+        switch (spec.type) {
+            case BoltzmannNodeType::ATOM: {
+                ret.size++;
+                if (ret.size > max_size) {
+                    return false;
+                }
+                auto index = new_list(task.parent);
+                ret.nodes[index].label = ret.size;
+                break;
+            }
+            case BoltzmannNodeType::EPSILON:
+                new_list(task.parent);
+                break;
+            case BoltzmannNodeType::RECURSION:
+                tasks.push_back(Task{root, task.level, task.parent, 0, 0});
+                break;
+            case BoltzmannNodeType::UNION: {
+                auto total = evaluate(task.node, task.level, nullptr);
+                auto u = uniform(rng);
+                auto chosen = spec.children.back();
+                for (auto child : spec.children) {
+                    u -= std::exp(evaluate(child, task.level, nullptr)-total);
+                    if (u <= 0) {
+                        chosen = child;
+                        break;
+                    }
+                }
+                tasks.push_back(Task{chosen, task.level, task.parent, 0, 0});
+                break;
+            }
+            case BoltzmannNodeType::PRODUCT: {
+                auto list = new_list(task.parent);
+                for (auto it = spec.children.rbegin(); it != spec.children.rend(); it++) {
+                    tasks.push_back(Task{*it, task.level, list, 0, 0});
+                }
+                break;
+            }
+            case BoltzmannNodeType::SEQ:
+            case BoltzmannNodeType::LSET:
+            case BoltzmannNodeType::LCYC: {
+                uint32_t count;
+                auto child = spec.children[0];
+                if (spec.restricted) {
+                    auto& weights = get_weights(task.node, task.level);
+                    count = draw_from_prefix_sums(weights, uniform(rng)*weights.back());
+                } else {
+                    auto a = std::exp(evaluate(child, task.level, nullptr));
+                    if (spec.type == BoltzmannNodeType::SEQ) {
+                        count = draw_geometric(rng, a);
+                    } else if (spec.type == BoltzmannNodeType::LSET) {
+                        count = draw_poisson(rng, a);
+                    } else {
+                        count = draw_logarithmic(rng, a);
+                    }
+                }
+                if (static_cast<uint64_t>(count)*nodes[child].min_size > max_size) {
+                    return false;
+                }
+                auto list = new_list(task.parent);
+                for (uint32_t ind = 0; ind < count; ind++) {
+                    tasks.push_back(Task{child, task.level, list, 0, 0});
+                }
+                break;
+            }
+            case BoltzmannNodeType::MSET: {
+                // the number of i-fold repeated components is Poisson(lambda_i), independently for all i; the largest i with a
+                // non-zero count is drawn first from P(K <= k) = exp(-sum_{i > k} lambda_i), so only the counts up to K have to be drawn
+                auto& prefix_sums = get_weights(task.node, task.level);
+                auto list = new_list(task.parent);
+                auto total = prefix_sums.empty() ? 0.0 : prefix_sums.back();
+                auto threshold = total+std::log(uniform(rng));
+                if (threshold <= 0) {
+                    break;
+                }
+                uint32_t largest = draw_from_prefix_sums(prefix_sums, threshold);
+                for (uint32_t ind = 0; ind <= largest; ind++) {
+                    auto lambda = prefix_sums[ind]-(ind > 0 ? prefix_sums[ind-1] : 0);
+                    auto count = ind == largest ? draw_positive_poisson(rng, lambda) : draw_poisson(rng, lambda);
+                    for (uint32_t copy = 0; copy < count; copy++) {
+                        if (ind > 0) {
+                            tasks.push_back(Task{task.node, task.level, list, 1, ind});
+                        }
+                        tasks.push_back(Task{spec.children[0], task.level*(ind+1), list, 0, 0});
+                    }
+                }
+                break;
+            }
+            case BoltzmannNodeType::CYC: {
+                // a cycle is a sequence of j components, repeated i times
+                auto& prefix_sums = get_weights(task.node, task.level);
+                auto ind = draw_from_prefix_sums(prefix_sums, uniform(rng)*prefix_sums.back());
+                auto level = task.level*(ind+1);
+                auto count = draw_logarithmic(rng, std::exp(evaluate(spec.children[0], level, nullptr)));
+                auto list = new_list(task.parent);
+                if (ind > 0) {
+                    tasks.push_back(Task{task.node, task.level, list, count, ind});
+                }
+                for (uint32_t copy = 0; copy < count; copy++) {
+                    tasks.push_back(Task{spec.children[0], level, list, 0, 0});
+                }
+                break;
+            }
+        }
+    }
+
+    return ret.size >= min_size;
+}
+
+BoltzmannObject BoltzmannSampler::sample(std::mt19937_64& rng, const uint64_t max_attempts) {
+    auto ret = BoltzmannObject();
+    for (uint64_t attempt = 0; attempt < max_attempts; attempt++) {
+        if (!sample_once(rng, ret)) {
+            continue;
+        }
+
+        if (labelled) {
+            auto labels = std::vector<uint32_t>(ret.size);
+            for (uint32_t ind = 0; ind < ret.size; ind++) {
+                labels[ind] = ind+1;
+            }
+            for (uint32_t ind = ret.size; ind > 1; ind--) {
+                std::swap(labels[ind-1], labels[rng() % ind]);
+            }
+            for (auto& node : ret.nodes) {
+                if (node.label != 0) {
+                    node.label = labels[node.label-1];
+                }
+            }
+        }
+        return ret;
+    }
+    throw std::runtime_error("Boltzmann sampler: no object of the requested size found");
+}
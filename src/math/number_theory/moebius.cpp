@@ -12,9 +12,8 @@
 /**
  * @brief Calculates the Möbius function for all numbers up to a given limit.
  *
- * This function calculates the Möbius function using sum(k <= n) floor(n/k)*mu(k) = 1
- *
- *
+ * Uses sum(d | n) mu(d) = [n == 1] and hence mu(n) = -sum(d | n, d < n) mu(d), which is tabulated
+ * by pushing each mu(d) onto its multiples in O(limit*log(limit)).
  *
  * @param limit The upper limit for the calculation.
  * @return A vector of Möbius function values for each number up to the limit.
@@ -22,13 +21,18 @@
 std::vector<int32_t> calculate_moebius(uint32_t limit) {
     auto ret = std::vector<int32_t>(limit+1);
 
-    for (uint32_t n = 1; n <= limit; n++) {
-        int32_t value = 1;
+    if (limit >= 1) {
+        ret[1] = 1;
+    }
 
-        for (uint32_t k = 1; k < n; k++) {
-            value = value - n/k*ret[k];
+    for (uint32_t d = 1; d <= limit; d++) {
+        auto mud = ret[d];
+        if (mud == 0) {
+            continue;
+        }
+        for (uint64_t multiple = 2*static_cast<uint64_t>(d); multiple <= limit; multiple += d) {
+            ret[multiple] -= mud;
         }
-        ret[n] = value;
     }
     return ret;
 }
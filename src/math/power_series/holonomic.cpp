@@ -0,0 +1,466 @@
+/**
+ * @file holonomic.cpp
+ * @brief Guessing of P-recursive (holonomic) recurrences and evaluation of single terms of such sequences.
+ */
+
+#include "math/power_series/holonomic.hpp"
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "math_utils/euclidean_algorithm.hpp"
+#include "math_utils/modular_polynomial_gcd.hpp"
+#include "exceptions/datatype_internal_exception.hpp"
+
+#define HOLONOMIC_MARGIN 5  // number of equations beyond the number of unknowns before an ansatz is trusted
+#define HOLONOMIC_MAX_PRIMES 64
+#define HOLONOMIC_FIRST_PRIME 2147483647  // primes below 2^31 keep all products in int64
+
+struct RecurrenceAnsatz {
+    uint32_t order;
+    uint32_t degree;
+
+    uint32_t num_unknowns() const {
+        return (order+1)*(degree+1);
+    }
+};
+
+static int64_t inverse_mod(const int64_t a, const int64_t p) {
+    auto res = extended_euclidean_algorithm<int64_t>(a, p);
+    if (res.gcd != 1) {
+        throw DatatypeInternalException("Cannot invert " + std::to_string(a) + " modulo " + std::to_string(p));
+    }
+    return ((res.bezouta % p)+p) % p;
+}
+
+/**
+ * @brief All ansatzes (order, degree) that are overdetermined for the given number of terms, by increasing number of unknowns.
+ */
+static std::vector<RecurrenceAnsatz> get_ansatz_list(const uint32_t num_terms) {
+    auto ret = std::vector<RecurrenceAnsatz>();
+    for (uint32_t order = 1; order < num_terms; order++) {
+        for (uint32_t degree = 0; ; degree++) {
+            auto ansatz = RecurrenceAnsatz{order, degree};
+            if (ansatz.num_unknowns()+HOLONOMIC_MARGIN > num_terms-order) {
+                break;
+            }
+            ret.push_back(ansatz);
+        }
+    }
+
+    std::sort(ret.begin(), ret.end(), [](const RecurrenceAnsatz& a, const RecurrenceAnsatz& b) {
+        if (a.num_unknowns() != b.num_unknowns()) {
+            return a.num_unknowns() < b.num_unknowns();
+        }
+        return a.order < b.order;
+    });
+    return ret;
+}
+
+/**
+ * @brief Kernel vector of the linear system of an ansatz modulo a prime.
+ *
+ * Unknown i*(degree+1)+j is the coefficient of n^j in p_i. The system is brought to reduced row echelon form, and the
+ * kernel vector is normalized to 1 at the first free column and 0 at all other free columns; this makes it canonical,
+ * so vectors for different primes can be combined.
+ *
+ * @param free_column Set to the first free column.
+ * @return The kernel vector, empty if the system has full column rank.
+ */
+static std::vector<int64_t> modular_kernel_vector(const std::vector<int64_t>& terms, const RecurrenceAnsatz& ansatz, const int64_t p, uint32_t& free_column) {
+    uint32_t columns = ansatz.num_unknowns();
+    uint32_t rows = terms.size()-ansatz.order;
+
+    auto matrix = std::vector<std::vector<int64_t>>(rows, std::vector<int64_t>(columns));
+    for (uint32_t n = 0; n < rows; n++) {
+        for (uint32_t i = 0; i <= ansatz.order; i++) {
+            int64_t value = terms[n+i];
+            for (uint32_t j = 0; j <= ansatz.degree; j++) {
+                matrix[n][i*(ansatz.degree+1)+j] = value;
+                value = (value*n) % p;
+            }
+        }
+    }
+
+    auto pivot_rows = std::vector<int64_t>(columns, -1);
+    uint32_t rank = 0;
+    for (uint32_t column = 0; column < columns && rank < rows; column++) {
+        uint32_t pivot = rank;
+        while (pivot < rows && matrix[pivot][column] == 0) {
+            pivot++;
+        }
+        if (pivot == rows) {
+            continue;
+        }
+        std::swap(matrix[pivot], matrix[rank]);
+
+        auto inverse = inverse_mod(matrix[rank][column], p);
+        for (uint32_t ind = column; ind < columns; ind++) {
+            matrix[rank][ind] = (matrix[rank][ind]*inverse) % p;
+        }
+
+        for (uint32_t row = 0; row < rows; row++) {
+            if (row == rank || matrix[row][column] == 0) {
+                continue;
+            }
+            auto factor = matrix[row][column];
+            for (uint32_t ind = column; ind < columns; ind++) {
+                matrix[row][ind] = (matrix[row][ind]-factor*matrix[rank][ind] % p+p) % p;
+            }
+        }
+        pivot_rows[column] = rank;
+        rank++;
+    }
+
+    if (rank == columns) {
+        return std::vector<int64_t>();
+    }
+
+    free_column = 0;
+    while (pivot_rows[free_column] >= 0) {
+        free_column++;
+    }
+
+    auto ret = std::vector<int64_t>(columns, 0);
+    ret[free_column] = 1;
+    for (uint32_t column = 0; column < columns; column++) {
+        if (pivot_rows[column] >= 0) {
+            ret[column] = (p-matrix[pivot_rows[column]][free_column]) % p;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Splits a kernel vector into the coefficient polynomials, dropping vanishing trailing polynomials.
+ */
+template<typename T>
+static std::vector<Polynomial<T>> kernel_to_recurrence(const std::vector<T>& kernel, const RecurrenceAnsatz& ansatz) {
+    auto ret = std::vector<Polynomial<T>>();
+    for (uint32_t i = 0; i <= ansatz.order; i++) {
+        auto coeffs = std::vector<T>(kernel.begin()+i*(ansatz.degree+1), kernel.begin()+(i+1)*(ansatz.degree+1));
+        auto poly = Polynomial<T>(std::move(coeffs));
+        poly.sanitize();
+        ret.push_back(poly);
+    }
+    while (ret.size() > 1 && ret.back().degree() < 0) {
+        ret.pop_back();
+    }
+    return ret;
+}
+
+std::vector<Polynomial<ModLong>> guess_recurrence(const std::vector<ModLong>& terms) {
+    if (terms.empty()) {
+        throw DatatypeInternalException("Cannot guess a recurrence without terms");
+    }
+    int64_t p = terms[0].get_modulus();
+
+    auto reduced = std::vector<int64_t>();
+    for (auto& term : terms) {
+        reduced.push_back(term.to_num());
+    }
+
+    for (auto& ansatz : get_ansatz_list(terms.size())) {
+        uint32_t free_column;
+        auto kernel = modular_kernel_vector(reduced, ansatz, p, free_column);
+        if (kernel.empty()) {
+            continue;
+        }
+        auto coefficients = std::vector<ModLong>();
+        for (auto x : kernel) {
+            coefficients.push_back(ModLong(x, p));
+        }
+        return kernel_to_recurrence(coefficients, ansatz);
+    }
+    throw DatatypeInternalException("No recurrence found, more terms are needed");
+}
+
+/**
+ * @brief Reduces rational terms modulo p; fails if a denominator is divisible by p.
+ */
+static bool reduce_terms(const std::vector<RationalNumber<BigInt>>& terms, const int64_t p, std::vector<int64_t>& reduced) {
+    reduced.clear();
+    auto modulus = BigInt(p);
+    for (auto& term : terms) {
+        auto denominator = (term.get_denominator() % modulus).as_int64();
+        if (denominator == 0) {
+            return false;
+        }
+        auto numerator = (term.get_numerator() % modulus).as_int64();
+        reduced.push_back((numerator*inverse_mod(denominator, p)) % p);
+    }
+    return true;
+}
+
+/**
+ * @brief Finds a/b = x mod m with |a|, |b| <= sqrt(m/2) (Wang's rational reconstruction), if it exists.
+ */
+static bool reconstruct_rational_number(const BigInt& x, const BigInt& m, RationalNumber<BigInt>& result) {
+    auto two = BigInt(2);
+    auto r0 = m;
+    auto r1 = x;
+    auto t0 = BigInt(0);
+    auto t1 = BigInt(1);
+    while (two*r1*r1 > m) {
+        auto quotient = r0/r1;
+        auto r2 = r0-quotient*r1;
+        r0 = r1;
+        r1 = r2;
+        auto t2 = t0-quotient*t1;
+        t0 = t1;
+        t1 = t2;
+    }
+
+    if (t1 == BigInt(0) || two*t1*t1 > m) {
+        return false;
+    }
+    if (t1 < 0) {
+        t1 = -t1;
+        r1 = -r1;
+    }
+    result = RationalNumber<BigInt>(r1, t1);
+    return true;
+}
+
+/**
+ * @brief Checks sum_i p_i(n)*a_{n+i} = 0 exactly for all n covered by the terms.
+ */
+static bool verify_recurrence(const std::vector<BigInt>& coefficients, const RecurrenceAnsatz& ansatz, const std::vector<RationalNumber<BigInt>>& terms) {
+    auto zero = RationalNumber<BigInt>(0);
+    for (uint32_t n = 0; n+ansatz.order < terms.size(); n++) {
+        auto sum = zero;
+        for (uint32_t i = 0; i <= ansatz.order; i++) {
+            auto value = BigInt(0);
+            for (uint32_t j = ansatz.degree+1; j-- > 0;) {
+                value = value*BigInt(n)+coefficients[i*(ansatz.degree+1)+j];
+            }
+            sum = sum+RationalNumber<BigInt>(value)*terms[n+i];
+        }
+        if (sum != zero) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Lifts a kernel vector known modulo m to coprime integers, if rational reconstruction succeeds.
+ */
+static bool lift_kernel_vector(const std::vector<BigInt>& kernel, const BigInt& m, std::vector<BigInt>& result) {
+    auto rationals = std::vector<RationalNumber<BigInt>>();
+    auto common_denominator = BigInt(1);
+    for (auto& x : kernel) {
+        auto rational = RationalNumber<BigInt>(0);
+        if (!reconstruct_rational_number(x, m, rational)) {
+            return false;
+        }
+        auto denominator = rational.get_denominator();
+        common_denominator = lcm(common_denominator, denominator);
+        rationals.push_back(rational);
+    }
+
+    result.clear();
+    auto content = BigInt(0);
+    for (auto& rational : rationals) {
+        result.push_back(rational.get_numerator()*(common_denominator/rational.get_denominator()));
+        auto abs_value = result.back() < 0 ? -result.back() : result.back();
+        content = gcd(content, abs_value);
+    }
+    for (auto& x : result) {
+        x = x/content;
+    }
+    return true;
+}
+
+std::vector<Polynomial<RationalNumber<BigInt>>> guess_recurrence(const std::vector<RationalNumber<BigInt>>& terms) {
+    if (terms.empty()) {
+        throw DatatypeInternalException("Cannot guess a recurrence without terms");
+    }
+
+    int64_t p = HOLONOMIC_FIRST_PRIME;
+    auto reduced = std::vector<int64_t>();
+    while (!reduce_terms(terms, p, reduced)) {
+        p = previous_prime(p);
+    }
+
+    // the ansatz is chosen with the first prime; a spurious kernel modulo p is possible but unlikely, and is caught by the verification
+    uint32_t free_column = 0;
+    auto kernel = std::vector<int64_t>();
+    auto ansatz = RecurrenceAnsatz{0, 0};
+    for (auto& candidate : get_ansatz_list(terms.size())) {
+        kernel = modular_kernel_vector(reduced, candidate, p, free_column);
+        if (!kernel.empty()) {
+            ansatz = candidate;
+            break;
+        }
+    }
+    if (kernel.empty()) {
+        throw DatatypeInternalException("No recurrence found, more terms are needed");
+    }
+
+    auto combined = std::vector<BigInt>();
+    for (auto x : kernel) {
+        combined.push_back(BigInt(x));
+    }
+    auto modulus = BigInt(p);
+
+    for (uint32_t num_primes = 1; num_primes < HOLONOMIC_MAX_PRIMES; ) {
+        auto lifted = std::vector<BigInt>();
+        if (lift_kernel_vector(combined, modulus, lifted) && verify_recurrence(lifted, ansatz, terms)) {
+            auto coefficients = std::vector<RationalNumber<BigInt>>();
+            for (auto& x : lifted) {
+                coefficients.push_back(RationalNumber<BigInt>(x));
+            }
+            return kernel_to_recurrence(coefficients, ansatz);
+        }
+
+        p = previous_prime(p);
+        if (!reduce_terms(terms, p, reduced)) {
+            continue;
+        }
+        uint32_t new_free_column = 0;
+        auto new_kernel = modular_kernel_vector(reduced, ansatz, p, new_free_column);
+        if (new_kernel.empty() || new_free_column != free_column) {
+            continue;
+        }
+
+        // Chinese remaindering: x + m*((y-x)/m mod p)
+        auto big_p = BigInt(p);
+        auto inverse = inverse_mod((modulus % big_p).as_int64(), p);
+        for (uint32_t ind = 0; ind < combined.size(); ind++) {
+            auto x_mod_p = (combined[ind] % big_p).as_int64();
+            auto t = (((new_kernel[ind]-x_mod_p+p) % p)*inverse) % p;
+            combined[ind] = combined[ind]+modulus*BigInt(t);
+        }
+        modulus = modulus*big_p;
+        num_primes++;
+    }
+    throw DatatypeInternalException("No recurrence found, more terms are needed");
+}
+
+ModLong recurrence_term(const std::vector<Polynomial<ModLong>>& recurrence, const std::vector<ModLong>& terms, const uint64_t index) {
+    if (index < terms.size()) {
+        return terms[index];
+    }
+    uint32_t order = recurrence.size()-1;
+    if (recurrence.size() < 2 || terms.size() < order) {
+        throw DatatypeInternalException("Recurrence of order at least 1 and at least as many initial terms as its order required");
+    }
+
+    auto p = terms[0].get_modulus();
+    auto window = std::vector<ModLong>(terms.end()-order, terms.end());
+    for (uint64_t n = terms.size()-order; n+order <= index; n++) {
+        auto argument = ModLong(static_cast<int64_t>(n % p), p);
+        auto evaluate = [&argument](const Polynomial<ModLong>& poly) {
+            auto ret = poly[poly.num_coefficients()-1];
+            for (uint32_t ind = poly.num_coefficients()-1; ind-- > 0;) {
+                ret = ret*argument+poly[ind];
+            }
+            return ret;
+        };
+
+        auto sum = ModLong(0, p);
+        for (uint32_t i = 0; i < order; i++) {
+            sum = sum+evaluate(recurrence[i])*window[i];
+        }
+        auto leading = evaluate(recurrence[order]);
+        if (leading == ModLong(0, p)) {
+            throw DatatypeInternalException("Leading coefficient of the recurrence vanishes at n = " + std::to_string(n));
+        }
+        for (uint32_t i = 0; i+1 < order; i++) {
+            window[i] = window[i+1];
+        }
+        window[order-1] = -sum/leading;
+    }
+    return window[order-1];
+}
+
+typedef std::vector<std::vector<BigInt>> BigIntMatrix;
+
+/**
+ * @brief Product A(hi-1)*...*A(lo) of the transition matrices and the product of p_r(n) over [lo, hi), as a balanced tree.
+ */
+static std::pair<BigIntMatrix, BigInt> recurrence_product(const std::vector<std::vector<BigInt>>& recurrence, const uint64_t lo, const uint64_t hi) {
+    uint32_t order = recurrence.size()-1;
+    if (hi-lo == 1) {
+        auto n = BigInt(static_cast<int64_t>(lo));
+        auto evaluate = [&n](const std::vector<BigInt>& poly) {
+            auto ret = BigInt(0);
+            for (uint32_t ind = poly.size(); ind-- > 0;) {
+                ret = ret*n+poly[ind];
+            }
+            return ret;
+        };
+
+        auto leading = evaluate(recurrence[order]);
+        auto matrix = BigIntMatrix(order, std::vector<BigInt>(order, BigInt(0)));
+        for (uint32_t row = 0; row+1 < order; row++) {
+            matrix[row][row+1] = leading;
+        }
+        for (uint32_t column = 0; column < order; column++) {
+            matrix[order-1][column] = -evaluate(recurrence[column]);
+        }
+        return std::make_pair(matrix, leading);
+    }
+
+    auto mid = lo+(hi-lo)/2;
+    auto left = recurrence_product(recurrence, lo, mid);
+    auto right = recurrence_product(recurrence, mid, hi);
+
+    auto matrix = BigIntMatrix(order, std::vector<BigInt>(order, BigInt(0)));
+    for (uint32_t row = 0; row < order; row++) {
+        for (uint32_t column = 0; column < order; column++) {
+            for (uint32_t ind = 0; ind < order; ind++) {
+                matrix[row][column] += right.first[row][ind]*left.first[ind][column];
+            }
+        }
+    }
+    return std::make_pair(matrix, right.second*left.second);
+}
+
+RationalNumber<BigInt> recurrence_term(const std::vector<Polynomial<RationalNumber<BigInt>>>& recurrence,
+                                       const std::vector<RationalNumber<BigInt>>& terms,
+                                       const uint64_t index) {
+    if (index < terms.size()) {
+        return terms[index];
+    }
+    uint32_t order = recurrence.size()-1;
+    if (recurrence.size() < 2 || terms.size() < order) {
+        throw DatatypeInternalException("Recurrence of order at least 1 and at least as many initial terms as its order required");
+    }
+
+    // integer coefficients: multiply all polynomials by the common denominator
+    auto common_denominator = BigInt(1);
+    for (auto& poly : recurrence) {
+        for (uint32_t ind = 0; ind < poly.num_coefficients(); ind++) {
+            auto denominator = poly[ind].get_denominator();
+            common_denominator = lcm(common_denominator, denominator);
+        }
+    }
+    auto integer_recurrence = std::vector<std::vector<BigInt>>();
+    for (auto& poly : recurrence) {
+        auto coeffs = std::vector<BigInt>();
+        for (uint32_t ind = 0; ind < poly.num_coefficients(); ind++) {
+            coeffs.push_back(poly[ind].get_numerator()*(common_denominator/poly[ind].get_denominator()));
+        }
+        integer_recurrence.push_back(coeffs);
+    }
+
+    auto start = terms.size()-order;
+    auto product = recurrence_product(integer_recurrence, start, index-order+1);
+    if (product.second == BigInt(0)) {
+        throw DatatypeInternalException("Leading coefficient of the recurrence vanishes");
+    }
+
+    auto initial_denominator = BigInt(1);
+    for (uint32_t ind = 0; ind < order; ind++) {
+        auto denominator = terms[start+ind].get_denominator();
+        initial_denominator = lcm(initial_denominator, denominator);
+    }
+    auto numerator = BigInt(0);
+    for (uint32_t ind = 0; ind < order; ind++) {
+        auto& term = terms[start+ind];
+        numerator += product.first[order-1][ind]*term.get_numerator()*(initial_denominator/term.get_denominator());
+    }
+    return RationalNumber<BigInt>(numerator, product.second*initial_denominator);
+}
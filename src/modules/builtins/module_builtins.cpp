@@ -1,3 +1,4 @@
+#include <sstream>
 #include "modules/module_registration/module_registration.hpp"
 #include "types/sym_types/sym_string_object.hpp"
 #include "types/sym_types/sym_void.hpp"
@@ -6,6 +7,7 @@
 #include "types/sym_types/sym_boolean.hpp"
 #include "types/sym_types/math_types/value_type.hpp"
 #include "exceptions/datatype_internal_exception.hpp"
+#include "common/kernel_stats.hpp"
 
 inline char as_ascii(std::shared_ptr<SymObject>& obj) {
     auto rational = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(obj);
@@ -35,6 +37,10 @@ inline char as_ascii(std::shared_ptr<SymObject>& obj) {
 
 // Helper: Extract integer index from RationalNumber
 inline int64_t extract_integer_index(const std::shared_ptr<SymObject>& index_obj, const std::string& func_name) {
+    int64_t small_index;
+    if (get_small_integer(*index_obj, small_index)) {
+        return small_index;
+    }
     auto index = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(index_obj);
     if (!index) {
         throw ParsingTypeException("Type error: Expected integer index in " + func_name);
@@ -75,10 +81,7 @@ inline std::shared_ptr<SymBooleanObject> get_boolean_argument(const std::shared_
 
 // Helper: Compare two numeric values of the same type
 template<typename T>
-bool compare_values(std::shared_ptr<ValueType<T>> first_val, std::shared_ptr<ValueType<T>> second_val, const std::string& op) {
-    auto first = first_val->as_value();
-    auto second = second_val->as_value();
-
+bool compare_values(const T& first, const T& second, const std::string& op) {
     if (op == "lt") return first < second;
     if (op == "lte") return first <= second;
     if (op == "gt") return first > second;
@@ -92,31 +95,38 @@ std::shared_ptr<SymObjectContainer> perform_numeric_comparison(
     const std::shared_ptr<SymObject>& first,
     const std::shared_ptr<SymObject>& second,
     const std::string& op) {
+    // Integers fitting into a machine word are compared natively
+    int64_t first_small, second_small;
+    if (get_small_integer(*first, first_small) && get_small_integer(*second, second_small)) {
+        return std::make_shared<SymObjectContainer>(std::make_shared<SymBooleanObject>(
+            compare_values<int64_t>(first_small, second_small, op)));
+    }
+
     auto first_num = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(first);
     auto second_num = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(second);
 
     if (first_num && second_num) {
         return std::make_shared<SymObjectContainer>(std::make_shared<SymBooleanObject>(
-            compare_values<RationalNumber<BigInt>>(first_num, second_num, op)));
+            compare_values<RationalNumber<BigInt>>(first_num->get_value(), second_num->get_value(), op)));
     }
 
     auto first_double = std::dynamic_pointer_cast<ValueType<double>>(first);
     auto second_double = std::dynamic_pointer_cast<ValueType<double>>(second);
     if (first_double && second_double) {
         return std::make_shared<SymObjectContainer>(std::make_shared<SymBooleanObject>(
-            compare_values<double>(first_double, second_double, op)));
+            compare_values<double>(first_double->get_value(), second_double->get_value(), op)));
     }
 
     if (first_double && second_num) {
         auto second_as_double = std::dynamic_pointer_cast<ValueType<double>>(second_num->as_double());
         return std::make_shared<SymObjectContainer>(std::make_shared<SymBooleanObject>(
-            compare_values<double>(first_double, second_as_double, op)));
+            compare_values<double>(first_double->get_value(), second_as_double->get_value(), op)));
     }
 
     if (first_num && second_double) {
         auto first_as_double = std::dynamic_pointer_cast<ValueType<double>>(first_num->as_double());
         return std::make_shared<SymObjectContainer>(std::make_shared<SymBooleanObject>(
-            compare_values<double>(first_as_double, second_double, op)));
+            compare_values<double>(first_as_double->get_value(), second_double->get_value(), op)));
     }
 
     throw ParsingTypeException("Type error: Expected numeric arguments for " + op + " operator");
@@ -192,6 +202,22 @@ Module create_builtins_module() {
     ret.register_function("println", 1, 2, [](std::vector<std::shared_ptr<SymObjectContainer>>& args, const std::shared_ptr<ModuleContextInterface>& context) {
         return print(args, context, true);
     });
+    ret.register_function("stats", 0, 1, [](std::vector<std::shared_ptr<SymObjectContainer>>& args, const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        if (args.size() == 1) {
+            auto command = std::dynamic_pointer_cast<SymStringObject>(args[0]->get_object());
+            if (!command || command->to_string() != "reset") {
+                throw ParsingTypeException("Type error: Expected \"reset\" as argument of stats function");
+            }
+            reset_kernel_statistics();
+            return std::make_shared<SymObjectContainer>(std::make_shared<SymVoidObject>());
+        }
+        std::stringstream strm;
+        write_kernel_statistics(strm);
+        auto report = strm.str();
+        report.pop_back();  // the final line break
+        return std::make_shared<SymObjectContainer>(std::make_shared<SymStringObject>(report));
+    });
     ret.register_function("list", 0, UINT32_MAX, [](std::vector<std::shared_ptr<SymObjectContainer>>& args, const std::shared_ptr<ModuleContextInterface>& context) {
         UNUSED(context);
         return std::make_shared<SymObjectContainer>(std::make_shared<SymListObject>(args));
@@ -203,7 +229,7 @@ Module create_builtins_module() {
             throw ParsingTypeException("Type error: Expected list argument for len function");
         }
         auto length = static_cast<int64_t>(list_obj->as_list().size());
-        return std::make_shared<SymObjectContainer>(std::make_shared<ValueType<RationalNumber<BigInt>>>(RationalNumber<BigInt>(BigInt(length), BigInt(1))));
+        return std::make_shared<SymObjectContainer>(make_small_integer(length));
     });
     ret.register_function("list_set", 3, 3, [](std::vector<std::shared_ptr<SymObjectContainer>>& args, const std::shared_ptr<ModuleContextInterface>& context) {
         UNUSED(context);
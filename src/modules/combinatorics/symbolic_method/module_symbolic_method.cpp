@@ -1,9 +1,17 @@
+#include <random>
+#include <stdexcept>
 #include "modules/module_registration/module_registration.hpp"
 #include "types/sym_types/sym_string_object.hpp"
 #include "types/sym_types/sym_math_object.hpp"
+#include "types/sym_types/sym_list.hpp"
+#include "types/sym_types/math_types/value_type.hpp"
+#include "types/bigint.hpp"
+#include "types/rationals.hpp"
+#include "cpp_utils/unused.hpp"
 #include "common/subset_parser.hpp"
 #include "exceptions/parsing_type_exception.hpp"
 #include "math/combinatorics/symbolic_method/symbolic_method_core.hpp"
+#include "math/combinatorics/symbolic_method/boltzmann_sampler.hpp"
 
 // Helper function to apply symbolic method operators
 inline std::shared_ptr<SymObjectContainer> apply_symbolic_method_operator(
@@ -31,6 +39,74 @@ inline std::shared_ptr<SymObjectContainer> apply_symbolic_method_operator(
     return std::make_shared<SymObjectContainer>(result->symbolic_method(op, fp_size, subset));
 }
 
+/**
+ * @brief Extracts a non-negative integer argument of a Boltzmann sampling function.
+ */
+static uint64_t get_boltzmann_integer(const std::shared_ptr<SymObject>& obj, const std::string& func_name, const uint64_t max_value) {
+    auto number = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(obj);
+    if (!number || number->as_value().get_denominator() != BigInt(1) || number->as_value().get_numerator() < 0) {
+        throw ParsingTypeException("Type error: Expected natural number as argument in " + func_name);
+    }
+    if (number->as_value().get_numerator() > BigInt(max_value)) {
+        throw ParsingTypeException("Type error: Argument too large in " + func_name);
+    }
+    return static_cast<uint64_t>(number->as_value().get_numerator().as_int64());
+}
+
+/**
+ * @brief Converts a sampled object to nested lists; atoms become "z" resp. their label.
+ */
+static std::shared_ptr<SymObject> boltzmann_object_to_list(const BoltzmannObject& obj, const bool labelled) {
+    // children always have larger indices than their parent, so the lists can be built back to front without recursion;
+    // node 0 is only the auxiliary list holding the object
+    auto converted = std::vector<std::shared_ptr<SymObject>>(obj.nodes.size());
+    for (size_t ind = obj.nodes.size(); ind-- > 1;) {
+        auto& node = obj.nodes[ind];
+        if (node.label != 0) {
+            if (labelled) {
+                converted[ind] = std::make_shared<ValueType<RationalNumber<BigInt>>>(RationalNumber<BigInt>(BigInt(node.label)));
+            } else {
+                converted[ind] = std::make_shared<SymStringObject>("z");
+            }
+            continue;
+        }
+        auto elements = std::vector<std::shared_ptr<SymObjectContainer>>();
+        for (auto child : node.children) {
+            elements.push_back(std::make_shared<SymObjectContainer>(converted[child]));
+            converted[child].reset();
+        }
+        converted[ind] = std::make_shared<SymListObject>(elements);
+    }
+    return converted[obj.root()];
+}
+
+/**
+ * @brief Creates a function drawing a random object of a specification with size in [min_size, max_size].
+ *
+ * Arguments: specification string, min_size, max_size and optionally a seed for reproducible samples.
+ */
+static auto create_boltzmann_function(const std::string& func_name, const bool labelled) {
+    return [func_name, labelled](std::vector<std::shared_ptr<SymObjectContainer>>& args, const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        auto spec = std::dynamic_pointer_cast<SymStringObject>(args[0]->get_object());
+        if (!spec) {
+            throw ParsingTypeException("Type error: Expected specification string as first argument in " + func_name);
+        }
+        auto min_size = get_boltzmann_integer(args[1]->get_object(), func_name, UINT32_MAX-1);
+        auto max_size = get_boltzmann_integer(args[2]->get_object(), func_name, UINT32_MAX-1);
+        uint64_t seed = args.size() > 3 ? get_boltzmann_integer(args[3]->get_object(), func_name, INT64_MAX) : std::random_device()();
+
+        try {
+            auto sampler = BoltzmannSampler(spec->to_string(), labelled, min_size, max_size);
+            auto rng = std::mt19937_64(seed);
+            auto obj = sampler.sample(rng);
+            return std::make_shared<SymObjectContainer>(boltzmann_object_to_list(obj, labelled));
+        } catch (std::runtime_error& e) {
+            throw ParsingTypeException(std::string("Type error: ") + e.what() + " in " + func_name);
+        }
+    };
+}
+
 Module create_symbolic_method_module() {
     Module ret = Module("symbolic_method");
 
@@ -62,5 +138,8 @@ Module create_symbolic_method_module() {
         return apply_symbolic_method_operator(args, context, SymbolicMethodOperator::INV_MSET, "INVMSET");
     });
 
+    ret.register_function("boltzmann", 3, 4, create_boltzmann_function("boltzmann", false));
+    ret.register_function("lboltzmann", 3, 4, create_boltzmann_function("lboltzmann", true));
+
     return ret;
 }
@@ -0,0 +1,132 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "modules/graphs/module_graphs.hpp"
+#include "types/sym_types/math_types/value_type.hpp"
+#include "types/sym_types/math_types/power_series_type.hpp"
+#include "types/sym_types/sym_math_object.hpp"
+#include "types/power_series.hpp"
+#include "types/bigint.hpp"
+#include "types/rationals.hpp"
+#include "types/modLong.hpp"
+#include "exceptions/parsing_type_exception.hpp"
+#include "math/combinatorics/graphs/graph_isomorphisms.hpp"
+
+#define MAX_TREE_VERTICES (1u << 24)  // the tree series are quasi-linear, so much larger sizes are feasible
+
+/**
+ * @brief Number of threads used for the partition sums; one per hardware thread.
+ */
+static uint32_t get_num_graph_threads() {
+    auto num_threads = std::thread::hardware_concurrency();
+    return num_threads == 0 ? 1 : num_threads;
+}
+
+/**
+ * @brief Extracts the number of vertices from the first argument of a graphs function.
+ */
+static uint32_t get_num_vertices(const std::shared_ptr<SymObject>& obj, const std::string& func_name, const uint32_t max_vertices) {
+    auto number = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(obj);
+    if (!number || number->as_value().get_denominator() != BigInt(1)) {
+        throw ParsingTypeException("Type error: Expected natural number as first argument in " + func_name);
+    }
+
+    auto num_vertices = number->as_value().get_numerator();
+    if (num_vertices < 0) {
+        throw ParsingTypeException("Type error: Expected non-negative number of vertices in " + func_name);
+    }
+    if (num_vertices > BigInt(max_vertices)) {
+        throw ParsingTypeException("Type error: Number of vertices too large in " + func_name);
+    }
+    return static_cast<uint32_t>(num_vertices.as_int64());
+}
+
+/**
+ * @brief Helper function to create a graph counting function.
+ *
+ * The created function takes the number of vertices and optionally a unit Mod(1, p); in the latter case the
+ * counts are calculated modulo p. The counting function is called with the zero and unit of the selected
+ * coefficient ring and the number of threads to use, and has to return a power series.
+ *
+ * @param func_name The name of the function for error messages
+ * @param counter Generic callable (num_vertices, zero, unit, num_threads) -> FormalPowerSeries
+ * @param max_vertices The largest accepted number of vertices
+ * @return A lambda function compatible with Module::register_function
+ */
+template<typename F>
+static auto create_graph_counting_function(const std::string& func_name, F counter, const uint32_t max_vertices = UINT16_MAX) {
+    return [func_name, counter, max_vertices](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+                                              const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        auto num_vertices = get_num_vertices(args[0]->get_object(), func_name, max_vertices);
+        auto num_threads = get_num_graph_threads();
+
+        if (args.size() == 2) {
+            auto mod_unit = std::dynamic_pointer_cast<ValueType<ModLong>>(args[1]->get_object());
+            if (!mod_unit) {
+                throw ParsingTypeException("Type error: Expected Mod(1, p) as second argument in " + func_name);
+            }
+            auto unit = RingCompanionHelper<ModLong>::get_unit(mod_unit->as_value());
+            auto zero = RingCompanionHelper<ModLong>::get_zero(unit);
+            auto res = counter(num_vertices, zero, unit, num_threads);
+            return std::make_shared<SymObjectContainer>(std::make_shared<PowerSeriesType<ModLong>>(res));
+        }
+
+        auto unit = RationalNumber<BigInt>(1);
+        auto zero = RationalNumber<BigInt>(0);
+        auto res = counter(num_vertices, zero, unit, num_threads);
+        return std::make_shared<SymObjectContainer>(std::make_shared<PowerSeriesType<RationalNumber<BigInt>>>(res));
+    };
+}
+
+Module create_graphs_module() {
+    Module ret = Module("graphs");
+
+    // graphs(n[, Mod(1, p)]) - coefficient of z^k is the number of graphs on k <= n vertices up to isomorphism
+    ret.register_function("graphs", 1, 2, create_graph_counting_function("graphs",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            return get_iso_classes_of_graphs_gf(num_vertices, zero, unit, num_threads);
+        }));
+
+    // connected_graphs(n[, Mod(1, p)]) - coefficient of z^k is the number of connected graphs on k <= n vertices up to isomorphism
+    ret.register_function("connected_graphs", 1, 2, create_graph_counting_function("connected_graphs",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            return get_iso_classes_of_connected_graphs_gf(num_vertices, zero, unit, num_threads);
+        }));
+
+    // graphs_by_edges(n[, Mod(1, p)]) - coefficient of z^k is the number of graphs on n vertices with k edges up to isomorphism
+    ret.register_function("graphs_by_edges", 1, 2, create_graph_counting_function("graphs_by_edges",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            return get_iso_classes_of_graphs_fixed_num_vertices_gf(num_vertices, (num_vertices*(num_vertices-1))/2, zero, unit, num_threads);
+        }));
+
+    // connected_graphs_by_edges(n[, Mod(1, p)]) - coefficient of z^k is the number of connected graphs on n vertices with k edges up to isomorphism
+    ret.register_function("connected_graphs_by_edges", 1, 2, create_graph_counting_function("connected_graphs_by_edges",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            return get_connected_graph_iso_types_by_edge_number(num_vertices, zero, unit, num_threads)[num_vertices];
+        }));
+
+    // rooted_trees(n[, Mod(1, p)]) - coefficient of z^k is the number of rooted trees on k <= n vertices up to isomorphism
+    ret.register_function("rooted_trees", 1, 2, create_graph_counting_function("rooted_trees",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            UNUSED(num_threads);
+            return get_rooted_trees_gf(num_vertices, zero, unit);
+        }, MAX_TREE_VERTICES));
+
+    // trees(n[, Mod(1, p)]) - coefficient of z^k is the number of unrooted trees on k <= n vertices up to isomorphism
+    ret.register_function("trees", 1, 2, create_graph_counting_function("trees",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            UNUSED(num_threads);
+            return get_trees_gf(num_vertices, zero, unit);
+        }, MAX_TREE_VERTICES));
+
+    // forests(n[, Mod(1, p)]) - coefficient of z^k is the number of forests on k <= n vertices up to isomorphism
+    ret.register_function("forests", 1, 2, create_graph_counting_function("forests",
+        [](const uint32_t num_vertices, const auto zero, const auto unit, const uint32_t num_threads) {
+            UNUSED(num_threads);
+            return get_forests_gf(num_vertices, zero, unit);
+        }, MAX_TREE_VERTICES));
+
+    return ret;
+}
@@ -1,5 +1,7 @@
 #include "modules/math/module_math.hpp"
 #include "types/sym_types/math_types/value_type.hpp"
+#include "types/sym_types/math_types/rational_function_type.hpp"
+#include "types/polynomial.hpp"
 #include "types/bigint.hpp"
 #include "types/rationals.hpp"
 #include "types/sym_types/sym_math_object.hpp"
@@ -28,6 +30,65 @@ static auto create_power_series_function(PowerSeriesBuiltinFunctionType type, co
     };
 }
 
+/**
+ * @brief Extracts a polynomial from a mathematical object, failing for proper rational functions and power series.
+ */
+template<typename T>
+static Polynomial<T> as_polynomial(const std::shared_ptr<MathWrapperType<T>>& obj) {
+    auto rational_function = obj->as_rational_function();
+    auto denominator = rational_function.get_denominator();
+    if (denominator.degree() != 0) {
+        throw ParsingTypeException("Type error: Expected polynomials in gcd function");
+    }
+    return rational_function.get_numerator()/denominator[0];
+}
+
+template<typename T>
+static std::shared_ptr<SymObjectContainer> polynomial_gcd(const std::shared_ptr<MathWrapperType<T>>& a,
+                                                          const std::shared_ptr<MathWrapperType<T>>& b) {
+    auto res = gcd(as_polynomial(a), as_polynomial(b));
+    auto unit = Polynomial<T>::get_unit(res[0]);
+    return std::make_shared<SymObjectContainer>(std::make_shared<RationalFunctionType<T>>(RationalFunction<T>(res, unit)));
+}
+
+/**
+ * @brief Creates the gcd function.
+ * Returns the non-negative gcd of two integers, or the gcd of two polynomials over Q or Z/pZ, normalized to constant
+ * term 1 (or monic if z divides it).
+ */
+static auto create_gcd_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        auto a = args[0]->get_object();
+        auto b = args[1]->get_object();
+
+        auto integer_a = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(a);
+        auto integer_b = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(b);
+        if (integer_a && integer_b && integer_a->as_value().get_denominator() == BigInt(1) && integer_b->as_value().get_denominator() == BigInt(1)) {
+            auto x = integer_a->as_value().get_numerator();
+            auto y = integer_b->as_value().get_numerator();
+            x = x < 0 ? -x : x;
+            y = y < 0 ? -y : y;
+            return std::make_shared<SymObjectContainer>(std::make_shared<ValueType<RationalNumber<BigInt>>>(RationalNumber<BigInt>(gcd(x, y))));
+        }
+
+        auto rational_a = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(a);
+        auto rational_b = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(b);
+        if (rational_a && rational_b) {
+            return polynomial_gcd(rational_a, rational_b);
+        }
+
+        auto mod_a = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(a);
+        auto mod_b = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(b);
+        if (mod_a && mod_b) {
+            return polynomial_gcd(mod_a, mod_b);
+        }
+
+        throw ParsingTypeException("Type error: Expected integers or polynomials with rational or Mod coefficients of the same type in gcd function");
+    };
+}
+
 Module create_math_module() {
     Module ret = Module("math");
 
@@ -47,6 +108,7 @@ Module create_math_module() {
     ret.register_function("sin", 1, 1, create_power_series_function(PowerSeriesBuiltinFunctionType::SIN, "sin"));
     ret.register_function("cos", 1, 1, create_power_series_function(PowerSeriesBuiltinFunctionType::COS, "cos"));
     ret.register_function("tan", 1, 1, create_power_series_function(PowerSeriesBuiltinFunctionType::TAN, "tan"));
+    ret.register_function("gcd", 2, 2, create_gcd_function());
 
     return ret;
 }
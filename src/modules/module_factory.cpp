@@ -4,6 +4,7 @@
 #include "modules/combinatorics/module_combinatorics.hpp"
 #include "modules/math/module_math.hpp"
 #include "modules/powerseries/module_powerseries.hpp"
+#include "modules/graphs/module_graphs.hpp"
 
 ModuleRegister create_module_register() {
     std::vector<std::function<Module()>> module_creators = {
@@ -11,7 +12,8 @@ ModuleRegister create_module_register() {
         create_string_module,
         create_combinatorics_module,
         create_math_module,
-        create_powerseries_module
+        create_powerseries_module,
+        create_graphs_module
     };
 
     ModuleRegister ret;
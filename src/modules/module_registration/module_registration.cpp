@@ -123,6 +123,39 @@ std::shared_ptr<SymObjectContainer> ModuleRegister::get_module_constant(std::que
      return module_it->second.get_constant(module_path);
 }
 
+const Module* ModuleRegister::find_parent_module(const std::vector<std::string>& parts) const {
+     if (parts.size() < 2) {
+         return nullptr;
+     }
+     auto module_it = modules.find(parts[0]);
+     if (module_it == modules.end()) {
+         return nullptr;
+     }
+     const Module* current = &module_it->second;
+     for (size_t i = 1; i+1 < parts.size() && current != nullptr; i++) {
+         current = current->get_submodule(parts[i]);
+     }
+     return current;
+}
+
+const ModuleFunction* ModuleRegister::find_module_function(const std::string& element_path) const {
+     auto parts = string_split(element_path, '.');
+     auto parent = find_parent_module(parts);
+     if (parent == nullptr) {
+         return nullptr;
+     }
+     return parent->find_function(parts.back());
+}
+
+const ModuleConstant* ModuleRegister::find_module_constant(const std::string& element_path) const {
+     auto parts = string_split(element_path, '.');
+     auto parent = find_parent_module(parts);
+     if (parent == nullptr) {
+         return nullptr;
+     }
+     return parent->find_constant(parts.back());
+}
+
 bool ModuleRegister::is_builtin(const std::string& name) const {
       auto builtins = modules.find("builtins");
       if (builtins == modules.end()) {
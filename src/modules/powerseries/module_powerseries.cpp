@@ -1,12 +1,22 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 #include "modules/powerseries/module_powerseries.hpp"
 #include "types/sym_types/math_types/value_type.hpp"
 #include "types/sym_types/math_types/rational_function_type.hpp"
 #include "types/sym_types/math_types/power_series_type.hpp"
 #include "types/sym_types/sym_math_object.hpp"
+#include "types/sym_types/sym_string_object.hpp"
+#include "types/sym_types/sym_list.hpp"
 #include "types/power_series.hpp"
 #include "types/bigint.hpp"
 #include "types/rationals.hpp"
 #include "exceptions/parsing_type_exception.hpp"
+#include "math/power_series/implicit_equations.hpp"
+#include "math/power_series/rational_reconstruction.hpp"
+#include "math/power_series/holonomic.hpp"
+#include "math/polynomials/multipoint_evaluation.hpp"
 
 /**
  * @brief Creates the O() Landau symbol function.
@@ -102,17 +112,40 @@ static auto create_coefficient_function(bool as_egf) {
             throw ParsingTypeException("Type error: Expected non-negative index in coefficient function");
         }
 
-        if (idx > BigInt(INT32_MAX)) {
-            throw ParsingTypeException("Type error: Coefficient index too large");
-        }
+        return std::make_shared<SymObjectContainer>(result->get_coefficient_as_sym_object(idx, as_egf));
+    };
+}
 
-        auto int_idx = idx.as_int64();
+/**
+ * @brief Creates the coeffs() function.
+ * Returns the list of the coefficients of z^a, ..., z^b; rational functions expand the range once instead of per
+ * coefficient.
+ */
+static auto create_coefficients_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
 
-        if (int_idx < 0) {
-            throw ParsingTypeException("Type error: Coefficient index negative");
+        auto result = std::dynamic_pointer_cast<SymMathObject>(args[0]->get_object());
+        if (!result) {
+            throw ParsingTypeException("Type error: Expected mathematical object as first argument in coeffs() function");
         }
 
-        return std::make_shared<SymObjectContainer>(result->get_coefficient_as_sym_object(int_idx, as_egf));
+        auto get_index = [](const std::shared_ptr<SymObjectContainer>& arg) {
+            auto number = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(arg->get_object());
+            if (!number || number->as_value().get_denominator() != BigInt(1) || number->as_value().get_numerator() < 0) {
+                throw ParsingTypeException("Type error: Expected natural numbers as range in coeffs() function");
+            }
+            return number->as_value().get_numerator();
+        };
+        auto first = get_index(args[1]);
+        auto last = get_index(args[2]);
+
+        auto elements = std::vector<std::shared_ptr<SymObjectContainer>>();
+        for (auto& coeff : result->get_coefficients_as_sym_objects(first, last)) {
+            elements.push_back(std::make_shared<SymObjectContainer>(coeff));
+        }
+        return std::make_shared<SymObjectContainer>(std::make_shared<SymListObject>(elements));
     };
 }
 
@@ -139,13 +172,369 @@ static auto create_eval_function() {
     };
 }
 
+/**
+ * @brief Evaluates the custom function func_name at the power series y and returns the result as a power series.
+ */
+template<typename T>
+static PowerSeries<T> evaluate_implicit_equation(const std::string& func_name, const PowerSeries<T>& y,
+                                                 const std::shared_ptr<ModuleContextInterface>& context) {
+    auto args = std::vector<std::shared_ptr<SymObject>>({std::make_shared<PowerSeriesType<T>>(y)});
+    auto result = std::dynamic_pointer_cast<MathWrapperType<T>>(context->call_custom_function(func_name, args));
+    if (!result) {
+        throw ParsingTypeException("Type error: Function " + func_name + " in solve() has to return a mathematical object of the same type as its argument");
+    }
+
+    auto ret = result->as_power_series(y.num_coefficients());
+    if (ret.num_coefficients() < y.num_coefficients()) {
+        throw ParsingTypeException("Type error: Function " + func_name + " in solve() returned a power series of lower precision than its argument");
+    }
+    return ret;
+}
+
+/**
+ * @brief Creates the solve() function.
+ * Takes the name of a custom function F of one argument and returns the power series solution of y = F(y).
+ */
+static auto create_solve_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        auto func_name = std::dynamic_pointer_cast<SymStringObject>(args[0]->get_object());
+        if (!func_name) {
+            throw ParsingTypeException("Type error: Expected function name as first argument in solve() function");
+        }
+
+        uint32_t num_coefficients = context->get_shell_parameters().powerseries_expansion_size;
+        if (args.size() == 2) {
+            auto number = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(args[1]->get_object());
+            if (!number || number->as_value().get_denominator() != BigInt(1)) {
+                throw ParsingTypeException("Type error: Expected natural number as second argument in solve() function");
+            }
+            auto size = number->as_value().get_numerator();
+            if (size <= 0 || size > BigInt(INT32_MAX)) {
+                throw ParsingTypeException("Type error: Invalid number of coefficients in solve() function");
+            }
+            num_coefficients = static_cast<uint32_t>(size.as_int64());
+        }
+
+        auto name = func_name->to_string();
+        auto start = std::make_shared<PowerSeriesType<RationalNumber<BigInt>>>(PowerSeries<RationalNumber<BigInt>>::get_zero(RationalNumber<BigInt>(0), 1));
+        auto constant = context->call_custom_function(name, {start});
+        auto equation = [&name, &context](const auto& y) {
+            return evaluate_implicit_equation(name, y, context);
+        };
+
+        if (auto rational = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(constant)) {
+            auto res = solve_implicit_equation(equation, rational->as_power_series(1)[0], num_coefficients);
+            return std::make_shared<SymObjectContainer>(std::make_shared<PowerSeriesType<RationalNumber<BigInt>>>(res));
+        }
+
+        if (auto mod = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(constant)) {
+            auto res = solve_implicit_equation(equation, mod->as_power_series(1)[0], num_coefficients);
+            return std::make_shared<SymObjectContainer>(std::make_shared<PowerSeriesType<ModLong>>(res));
+        }
+
+        if (auto dbl = std::dynamic_pointer_cast<MathWrapperType<double>>(constant)) {
+            auto res = solve_implicit_equation(equation, dbl->as_power_series(1)[0], num_coefficients);
+            return std::make_shared<SymObjectContainer>(std::make_shared<PowerSeriesType<double>>(res));
+        }
+
+        throw ParsingTypeException("Type error: Function " + name + " in solve() has to return a mathematical object");
+    };
+}
+
+/**
+ * @brief All coefficients of a power series, or the expansion of another mathematical object to the default expansion size.
+ */
+template<typename T>
+static PowerSeries<T> get_known_coefficients(const std::shared_ptr<MathWrapperType<T>>& obj, const uint32_t expansion_size) {
+    auto power_series = std::dynamic_pointer_cast<PowerSeriesType<T>>(obj);
+    return power_series ? power_series->as_power_series(UINT32_MAX) : obj->as_power_series(expansion_size);
+}
+
+/**
+ * @brief Reconstructs a rational function from a power series; all coefficients of power series are used, other
+ * objects are expanded to the default expansion size.
+ */
+template<typename T>
+static std::shared_ptr<SymObjectContainer> reconstruct_rational_function(const std::shared_ptr<MathWrapperType<T>>& obj,
+                                                                         const uint32_t expansion_size) {
+    auto res = rational_reconstruction(get_known_coefficients(obj, expansion_size));
+    return std::make_shared<SymObjectContainer>(std::make_shared<RationalFunctionType<T>>(res));
+}
+
+/**
+ * @brief Creates the rational_reconstruct() function.
+ * Finds the rational function matching the coefficients of a power series, for rational or Mod coefficients.
+ */
+static auto create_rational_reconstruct_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        auto expansion_size = context->get_shell_parameters().powerseries_expansion_size;
+        auto obj = args[0]->get_object();
+
+        if (auto rational = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(obj)) {
+            return reconstruct_rational_function(rational, expansion_size);
+        }
+
+        if (auto mod = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(obj)) {
+            return reconstruct_rational_function(mod, expansion_size);
+        }
+
+        throw ParsingTypeException("Type error: Expected power series with rational or Mod coefficients in rational_reconstruct() function");
+    };
+}
+
+/**
+ * @brief Guesses a recurrence with polynomial coefficients for the known coefficients of obj, as a list of polynomials.
+ */
+template<typename T>
+static std::shared_ptr<SymObjectContainer> guess_recurrence_list(const std::shared_ptr<MathWrapperType<T>>& obj,
+                                                                 const uint32_t expansion_size) {
+    auto recurrence = guess_recurrence(get_known_coefficients(obj, expansion_size).copy_coefficients());
+    auto elements = std::vector<std::shared_ptr<SymObjectContainer>>();
+    for (auto& poly : recurrence) {
+        auto unit = Polynomial<T>::get_unit(poly[0]);
+        elements.push_back(std::make_shared<SymObjectContainer>(std::make_shared<RationalFunctionType<T>>(RationalFunction<T>(poly, unit))));
+    }
+    return std::make_shared<SymObjectContainer>(std::make_shared<SymListObject>(elements));
+}
+
+/**
+ * @brief Creates the guess_recurrence() function.
+ * Returns the list of polynomials [p_0, ..., p_r] with sum_i p_i(n)*a_{n+i} = 0 for the coefficients a_n of a power series.
+ */
+static auto create_guess_recurrence_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        auto expansion_size = context->get_shell_parameters().powerseries_expansion_size;
+        auto obj = args[0]->get_object();
+
+        if (auto rational = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(obj)) {
+            return guess_recurrence_list(rational, expansion_size);
+        }
+
+        if (auto mod = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(obj)) {
+            return guess_recurrence_list(mod, expansion_size);
+        }
+
+        throw ParsingTypeException("Type error: Expected power series with rational or Mod coefficients in guess_recurrence() function");
+    };
+}
+
+/**
+ * @brief Calculates a term of the sequence given by a recurrence list and the known coefficients of obj.
+ */
+template<typename T>
+static std::shared_ptr<SymObjectContainer> calculate_recurrence_term(const std::shared_ptr<SymListObject>& recurrence_list,
+                                                                     const std::shared_ptr<MathWrapperType<T>>& obj,
+                                                                     const uint64_t index,
+                                                                     const uint32_t expansion_size) {
+    auto recurrence = std::vector<Polynomial<T>>();
+    for (auto& element : recurrence_list->as_list()) {
+        auto poly = std::dynamic_pointer_cast<MathWrapperType<T>>(element->get_object());
+        if (!poly) {
+            throw ParsingTypeException("Type error: Expected list of polynomials with the coefficient type of the power series in recurrence_term() function");
+        }
+        auto rational_function = poly->as_rational_function();
+        auto denominator = rational_function.get_denominator();
+        if (denominator.degree() != 0) {
+            throw ParsingTypeException("Type error: Expected list of polynomials in recurrence_term() function");
+        }
+        recurrence.push_back(rational_function.get_numerator()/denominator[0]);
+    }
+
+    auto terms = get_known_coefficients(obj, expansion_size).copy_coefficients();
+    auto res = recurrence_term(recurrence, terms, index);
+    return std::make_shared<SymObjectContainer>(std::make_shared<ValueType<T>>(res));
+}
+
+/**
+ * @brief Creates the recurrence_term() function.
+ * Takes a recurrence as returned by guess_recurrence(), a power series with the initial terms and an index n, and
+ * returns the n-th term of the sequence without expanding the power series up to n.
+ */
+static auto create_recurrence_term_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        auto expansion_size = context->get_shell_parameters().powerseries_expansion_size;
+
+        auto recurrence_list = std::dynamic_pointer_cast<SymListObject>(args[0]->get_object());
+        if (!recurrence_list) {
+            throw ParsingTypeException("Type error: Expected list of polynomials as first argument in recurrence_term() function");
+        }
+
+        auto number = std::dynamic_pointer_cast<ValueType<RationalNumber<BigInt>>>(args[2]->get_object());
+        if (!number || number->as_value().get_denominator() != BigInt(1) || number->as_value().get_numerator() < 0) {
+            throw ParsingTypeException("Type error: Expected natural number as third argument in recurrence_term() function");
+        }
+        if (number->as_value().get_numerator() > BigInt(UINT32_MAX)) {
+            throw ParsingTypeException("Type error: Index too large in recurrence_term() function");
+        }
+        uint64_t index = number->as_value().get_numerator().as_int64();
+
+        auto obj = args[1]->get_object();
+        if (auto rational = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(obj)) {
+            return calculate_recurrence_term(recurrence_list, rational, index, expansion_size);
+        }
+
+        if (auto mod = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(obj)) {
+            return calculate_recurrence_term(recurrence_list, mod, index, expansion_size);
+        }
+
+        throw ParsingTypeException("Type error: Expected power series with rational or Mod coefficients as second argument in recurrence_term() function");
+    };
+}
+
+static std::shared_ptr<SymMathObject> promote_math_object(const std::shared_ptr<SymMathObject>& obj, const RationalNumber<BigInt>& reference) {
+    UNUSED(reference);
+    return obj;
+}
+
+static std::shared_ptr<SymMathObject> promote_math_object(const std::shared_ptr<SymMathObject>& obj, const ModLong& reference) {
+    return obj->as_modlong(reference.get_modulus());
+}
+
+static std::shared_ptr<SymMathObject> promote_math_object(const std::shared_ptr<SymMathObject>& obj, const double& reference) {
+    UNUSED(reference);
+    return obj->as_double();
+}
+
+/**
+ * @brief Calls callback with a value of the common coefficient type of the objects: Mod if any of them has Mod
+ * coefficients, double if any has double coefficients, rational otherwise.
+ */
+template<typename F>
+static std::shared_ptr<SymObjectContainer> dispatch_on_coefficient_type(const std::vector<std::shared_ptr<SymMathObject>>& objects, F&& callback) {
+    for (auto& obj : objects) {
+        if (auto mod = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(obj)) {
+            return callback(mod->as_power_series(1)[0]);
+        }
+    }
+    for (auto& obj : objects) {
+        if (std::dynamic_pointer_cast<MathWrapperType<double>>(obj)) {
+            return callback(1.0);
+        }
+    }
+    return callback(RationalNumber<BigInt>(1));
+}
+
+/**
+ * @brief Extracts the mathematical objects of a list argument.
+ */
+static std::vector<std::shared_ptr<SymMathObject>> get_math_list(const std::shared_ptr<SymObject>& obj, const std::string& func_name) {
+    auto list = std::dynamic_pointer_cast<SymListObject>(obj);
+    if (!list) {
+        throw ParsingTypeException("Type error: Expected list of numbers in " + func_name + "() function");
+    }
+    auto ret = std::vector<std::shared_ptr<SymMathObject>>();
+    for (auto& element : list->as_list()) {
+        auto math_obj = std::dynamic_pointer_cast<SymMathObject>(element->get_object());
+        if (!math_obj) {
+            throw ParsingTypeException("Type error: Expected list of numbers in " + func_name + "() function");
+        }
+        ret.push_back(math_obj);
+    }
+    return ret;
+}
+
+template<typename T>
+static std::vector<T> promote_to_values(const std::vector<std::shared_ptr<SymMathObject>>& objects, const T& reference, const std::string& func_name) {
+    auto ret = std::vector<T>();
+    for (auto& obj : objects) {
+        auto value = std::dynamic_pointer_cast<ValueType<T>>(promote_math_object(obj, reference));
+        if (!value) {
+            throw ParsingTypeException("Type error: Expected list of numbers in " + func_name + "() function");
+        }
+        ret.push_back(value->as_value());
+    }
+    return ret;
+}
+
+/**
+ * @brief Creates the multipoint_eval() function.
+ * Evaluates a rational function at all points of a list, with a subproduct tree instead of one Horner scheme per point.
+ */
+static auto create_multipoint_eval_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        auto f = std::dynamic_pointer_cast<SymMathObject>(args[0]->get_object());
+        if (!f) {
+            throw ParsingTypeException("Type error: Expected rational function as first argument in multipoint_eval() function");
+        }
+        auto points = get_math_list(args[1]->get_object(), "multipoint_eval");
+
+        auto objects = points;
+        objects.push_back(f);
+        return dispatch_on_coefficient_type(objects, [&f, &points](const auto& reference) {
+            using T = std::decay_t<decltype(reference)>;
+            auto values = promote_to_values(points, reference, "multipoint_eval");
+            auto elements = std::vector<std::shared_ptr<SymObjectContainer>>();
+            if (values.empty()) {
+                return std::make_shared<SymObjectContainer>(std::make_shared<SymListObject>(elements));
+            }
+
+            auto promoted = std::dynamic_pointer_cast<MathWrapperType<T>>(promote_math_object(f, reference));
+            if (!promoted || std::dynamic_pointer_cast<PowerSeriesType<T>>(promoted)) {
+                throw ParsingTypeException("Type error: Expected rational function as first argument in multipoint_eval() function");
+            }
+            auto rational_function = promoted->as_rational_function();
+
+            auto tree = SubproductTree<T>(values);
+            auto numerators = tree.evaluate(rational_function.get_numerator());
+            auto denominators = tree.evaluate(rational_function.get_denominator());
+            auto zero = RingCompanionHelper<T>::get_zero(reference);
+            for (uint32_t ind = 0; ind < values.size(); ind++) {
+                if (denominators[ind] == zero) {
+                    throw ParsingTypeException("Type error: Denominator vanishes at a point in multipoint_eval() function");
+                }
+                elements.push_back(std::make_shared<SymObjectContainer>(std::make_shared<ValueType<T>>(numerators[ind]/denominators[ind])));
+            }
+            return std::make_shared<SymObjectContainer>(std::make_shared<SymListObject>(elements));
+        });
+    };
+}
+
+/**
+ * @brief Creates the interpolate() function.
+ * Returns the polynomial of least degree through the given points and values, via a subproduct tree.
+ */
+static auto create_interpolate_function() {
+    return [](std::vector<std::shared_ptr<SymObjectContainer>>& args,
+              const std::shared_ptr<ModuleContextInterface>& context) {
+        UNUSED(context);
+        auto points = get_math_list(args[0]->get_object(), "interpolate");
+        auto values = get_math_list(args[1]->get_object(), "interpolate");
+        if (points.size() != values.size() || points.empty()) {
+            throw ParsingTypeException("Type error: Expected non-empty lists of points and values of the same length in interpolate() function");
+        }
+
+        auto objects = points;
+        objects.insert(objects.end(), values.begin(), values.end());
+        return dispatch_on_coefficient_type(objects, [&points, &values](const auto& reference) {
+            using T = std::decay_t<decltype(reference)>;
+            auto tree = SubproductTree<T>(promote_to_values(points, reference, "interpolate"));
+            auto res = tree.interpolate(promote_to_values(values, reference, "interpolate"));
+            auto unit = Polynomial<T>::get_unit(reference);
+            return std::make_shared<SymObjectContainer>(std::make_shared<RationalFunctionType<T>>(RationalFunction<T>(res, unit)));
+        });
+    };
+}
+
 Module create_powerseries_module() {
     Module ret = Module("powerseries");
 
     ret.register_function("O", 1, 1, create_landau_function());
     ret.register_function("coeff", 2, 2, create_coefficient_function(false));
     ret.register_function("egfcoeff", 2, 2, create_coefficient_function(true));
+    ret.register_function("coeffs", 3, 3, create_coefficients_function());
     ret.register_function("eval", 2, 2, create_eval_function());
+    ret.register_function("solve", 1, 2, create_solve_function());
+    ret.register_function("rational_reconstruct", 1, 1, create_rational_reconstruct_function());
+    ret.register_function("guess_recurrence", 1, 1, create_guess_recurrence_function());
+    ret.register_function("recurrence_term", 3, 3, create_recurrence_term_function());
+    ret.register_function("multipoint_eval", 2, 2, create_multipoint_eval_function());
+    ret.register_function("interpolate", 2, 2, create_interpolate_function());
 
     return ret;
 }
@@ -13,6 +13,8 @@
 #include "types/sym_types/sym_void.hpp"
 #include "interpreter/context.hpp"
 #include "preprocessor/preprocess.hpp"
+#include "interpreter/polish_notation/polish_optimizer.hpp"
+#include "interpreter/polish_notation/polish_bytecode.hpp"
 
 /**
  * @brief Parses a formula based on the given datatype.
@@ -33,9 +35,19 @@ std::shared_ptr<SymObject> parse_formula_internal(LexerDeque<ParsedCodeElement>&
         input.pop_front();
         polish_input.push_back(polish_notation_element_from_lexer(element));
     }
-    while (!polish_input.is_empty()) {
-        ret = iterate_wrapped(polish_input, context)->get_object();
+    polish_input = optimize_polish_program(polish_input, context);
+    std::shared_ptr<BytecodeProgram> program = nullptr;
+    if (context->get_shell_parameters().bytecode_execution) {
+        program = compile_bytecode(polish_input, context);
     }
+    if (program) {
+        ret = run_bytecode(*program, context);
+    } else {
+        while (!polish_input.is_empty()) {
+            ret = iterate_wrapped(polish_input, context)->get_object();
+        }
+    }
+    context->reset_position();  // the elements of the program are freed on return
     return ret;
 }
 
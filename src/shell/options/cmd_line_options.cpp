@@ -6,10 +6,11 @@ CmdLineOptions parse_cmd_line_args(int argc, char **argv) {
     CmdLineOptions options;
     options.input_file      = std::nullopt;
     options.output_file     = std::nullopt;
+    options.profile_file    = std::nullopt;
     options.repl_mode       = true;
     int opt;
     optind = 0;  // necessary to reset getopt for non-global use (eg in tests)
-    while ((opt = getopt(argc, argv, "i:o:pslh")) != -1) {
+    while ((opt = getopt(argc, argv, "i:o:f:pslh")) != -1) {
         switch (opt) {
             case 'i':
                 options.input_file = optarg;
@@ -18,6 +19,9 @@ CmdLineOptions parse_cmd_line_args(int argc, char **argv) {
             case 'o':
                 options.output_file = optarg;
                 break;
+            case 'f':
+                options.profile_file = optarg;
+                break;
             case 'p':
                 options.profile_output = true;
                 break;
@@ -18,6 +18,28 @@ struct ParameterDescription {
     ParameterSetter setter;
 };
 
+// Helper function to create the description of a boolean parameter
+static ParameterDescription create_bool_parameter_description(const std::string& description, bool ShellParameters::* parameter) {
+    return {
+        "bool",
+        description,
+        [parameter](const ShellParameters& params) -> std::string {
+            return params.*parameter ? "true" : "false";
+        },
+        [parameter](ShellParameters& params, const std::string& value) -> CommandResult {
+            if (value == "true") {
+                params.*parameter = true;
+                return CommandResult{"Parameter updated", true};
+            } else if (value == "false") {
+                params.*parameter = false;
+                return CommandResult{"Parameter updated", true};
+            } else {
+                return CommandResult{"Invalid value for boolean; expected 'true' or 'false'", false};
+            }
+        }
+    };
+}
+
 // Helper function to create parameter descriptions
 static std::map<std::string, ParameterDescription> create_parameter_descriptions() {
     return {
@@ -43,62 +65,50 @@ static std::map<std::string, ParameterDescription> create_parameter_descriptions
             }
         },
         {
-            "profile_output", {
-                "bool",
+            "profile_output", create_bool_parameter_description(
                 "Whether to output profiling information after each evaluation",
-                [](const ShellParameters& params) -> std::string {
-                    return params.profile_output ? "true" : "false";
-                },
-                [](ShellParameters& params, const std::string& value) -> CommandResult {
-                    if (value == "true") {
-                        params.profile_output = true;
-                        return CommandResult{"Parameter updated", true};
-                    } else if (value == "false") {
-                        params.profile_output = false;
-                        return CommandResult{"Parameter updated", true};
-                    } else {
-                        return CommandResult{"Invalid value for boolean; expected 'true' or 'false'", false};
-                    }
-                }
-            }
+                &ShellParameters::profile_output)
         },
         {
-            "lexer_output", {
-                "bool",
+            "lexer_output", create_bool_parameter_description(
                 "Whether to output profiling information for the lexer",
-                [](const ShellParameters& params) -> std::string {
-                    return params.lexer_output ? "true" : "false";
-                },
-                [](ShellParameters& params, const std::string& value) -> CommandResult {
-                    if (value == "true") {
-                        params.lexer_output = true;
-                        return CommandResult{"Parameter updated", true};
-                    } else if (value == "false") {
-                        params.lexer_output = false;
-                        return CommandResult{"Parameter updated", true};
-                    } else {
-                        return CommandResult{"Invalid value for boolean; expected 'true' or 'false'", false};
-                    }
-                }
-            }
+                &ShellParameters::lexer_output)
         },
         {
-            "shunting_yard_output", {
-                "bool",
+            "shunting_yard_output", create_bool_parameter_description(
                 "Whether to output profiling information for the shunting yard algorithm",
+                &ShellParameters::shunting_yard_output)
+        },
+        {
+            "constant_folding", create_bool_parameter_description(
+                "Whether to evaluate constant subexpressions, including math and powerseries functions, before execution",
+                &ShellParameters::constant_folding)
+        },
+        {
+            "hoist_loop_invariants", create_bool_parameter_description(
+                "Whether to evaluate loop-invariant expressions only once per execution of a while or for loop",
+                &ShellParameters::hoist_loop_invariants)
+        },
+        {
+            "inline_functions", create_bool_parameter_description(
+                "Whether to inline calls of small non-recursive functions consisting of a single expression",
+                &ShellParameters::inline_functions)
+        },
+        {
+            "bytecode_execution", create_bool_parameter_description(
+                "Whether to execute programs compiled to bytecode; if false, the polish notation is interpreted directly, which is slower but easier to debug",
+                &ShellParameters::bytecode_execution)
+        },
+        {
+            "profile_file", {
+                "string",
+                "File the sampling profiler writes collapsed stacks for flamegraph tools to after each evaluation; 'none' to turn profiling off",
                 [](const ShellParameters& params) -> std::string {
-                    return params.shunting_yard_output ? "true" : "false";
+                    return params.profile_file.empty() ? "none" : params.profile_file;
                 },
                 [](ShellParameters& params, const std::string& value) -> CommandResult {
-                    if (value == "true") {
-                        params.shunting_yard_output = true;
-                        return CommandResult{"Parameter updated", true};
-                    } else if (value == "false") {
-                        params.shunting_yard_output = false;
-                        return CommandResult{"Parameter updated", true};
-                    } else {
-                        return CommandResult{"Invalid value for boolean; expected 'true' or 'false'", false};
-                    }
+                    params.profile_file = value == "none" ? "" : value;
+                    return CommandResult{"Parameter updated", true};
                 }
             }
         }
@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <set>
+#include <sstream>
 #include "interpreter/context.hpp"
 #include "parsing/expression_parsing/math_expression_parser.hpp"
 #include "modules/module_factory.hpp"
@@ -339,3 +340,83 @@ TEST_F(InterpreterContextTest, ConstantsCannotBeOverriddenByVariables) {
     EXPECT_TRUE(isAutocompletable("false"));
     EXPECT_TRUE(isAutocompletable("null"));
 }
+
+// ============================================================================
+// Test 13: Variables With Slots in the Frame Layout
+// ============================================================================
+TEST_F(InterpreterContextTest, FrameLayoutSlots) {
+    auto layout = std::make_shared<FrameLayout>();
+    auto slot_a = layout->add_variable("a");
+    auto slot_b = layout->add_variable("b");
+    EXPECT_EQ(slot_a, layout->add_variable("a"));
+    EXPECT_EQ(layout->find_slot("b"), slot_b);
+    EXPECT_EQ(layout->find_slot("c"), -1);
+
+    context->set_variable("a", std::make_shared<SymBooleanObject>(true));
+    context->push_variables(layout);
+
+    // slotted variables are visible by slot and by name, and start unassigned
+    EXPECT_EQ(context->get_local(slot_a), nullptr);
+    EXPECT_EQ(context->get_variable("a"), nullptr);
+    EXPECT_FALSE(isAutocompletable("a"));
+    context->set_local(slot_a, std::make_shared<SymBooleanObject>(false));
+    EXPECT_EQ(context->get_variable("a")->to_string(), "false");
+    EXPECT_TRUE(isAutocompletable("a"));
+    context->set_variable("b", std::make_shared<SymVoidObject>());
+    EXPECT_EQ(context->get_local(slot_b)->to_string(), context->get_variable("b")->to_string());
+
+    // variables without slot are stored by name
+    context->set_variable("c", std::make_shared<SymBooleanObject>(true));
+    EXPECT_EQ(context->get_variable("c")->to_string(), "true");
+
+    // nested frames of the same layout do not share slots
+    context->push_variables(layout);
+    EXPECT_EQ(context->get_local(slot_a), nullptr);
+    EXPECT_EQ(context->get_variable("c"), nullptr);
+    context->pop_variables();
+
+    EXPECT_EQ(context->get_local(slot_a)->to_string(), "false");
+    context->pop_variables();
+    EXPECT_EQ(context->get_variable("a")->to_string(), "true");
+    EXPECT_EQ(context->get_variable("c"), nullptr);
+}
+
+// ============================================================================
+// Test 14: Samples of the Profiler Attributed to the Call Stack
+// ============================================================================
+TEST_F(InterpreterContextTest, ProfilerAttributesSamples) {
+    EXPECT_EQ(context->start_profiler(), nullptr);
+
+    auto profiler = SamplingProfiler();
+    auto outer = std::string("f");
+    auto inner = std::string("g");
+    profiler.enter(outer, nullptr, true);
+    profiler.enter(inner, nullptr, false);
+    profiler.enter(outer, nullptr, true);
+    profiler.record_sample(nullptr, 10, context);
+    profiler.leave();
+    profiler.leave();
+    profiler.record_sample(nullptr, 12, context);
+    profiler.leave();
+    profiler.record_sample(nullptr, 15, context);
+
+    auto& functions = profiler.get_functions();
+    ASSERT_EQ(functions.size(), 3);
+    // recursive calls count once per sample
+    EXPECT_EQ(functions.at("f").inclusive.samples, 2);
+    EXPECT_EQ(functions.at("f").inclusive.steps, 12);
+    EXPECT_EQ(functions.at("f").exclusive.steps, 12);
+    EXPECT_EQ(functions.at("g").inclusive.steps, 10);
+    EXPECT_EQ(functions.at("g").exclusive.steps, 0);
+    EXPECT_EQ(functions.at("<toplevel>").inclusive.steps, 15);
+    EXPECT_EQ(functions.at("<toplevel>").exclusive.steps, 3);
+    EXPECT_TRUE(profiler.get_lines().empty());
+
+    std::stringstream stacks;
+    profiler.write_collapsed_stacks(stacks);
+    auto collapsed = std::vector<std::string>();
+    for (std::string line; std::getline(stacks, line);) {
+        collapsed.push_back(line.substr(0, line.rfind(' ')));
+    }
+    EXPECT_EQ(collapsed, (std::vector<std::string>{"<toplevel>", "<toplevel>;f", "<toplevel>;f;g;f"}));
+}
@@ -329,3 +329,37 @@ TEST_F(ModuleConstantsTest, FunctionVsConstantDistinction) {
     EXPECT_FALSE(test_module.has_function("const"));
     EXPECT_TRUE(test_module.has_constant("const"));
 }
+
+// Test 19: Looking up elements by full path without exceptions
+TEST_F(ModuleConstantsTest, FindModuleElementsByPath) {
+    ModuleRegister registry;
+
+    Module child("child");
+    child.register_constant("NESTED", make_bigint_constant(456));
+    child.register_function("func", 0, 0,
+        [](std::vector<std::shared_ptr<SymObjectContainer>>&,
+           const std::shared_ptr<ModuleContextInterface>&) {
+            return std::make_shared<SymObjectContainer>(
+                std::make_shared<ValueType<double>>(0.0));
+        });
+
+    Module parent("parent");
+    parent.register_constant("CONST", make_bigint_constant(123));
+    parent.register_submodule("child", child);
+    registry.register_module("parent", parent);
+
+    EXPECT_NE(registry.find_module_constant("parent.CONST"), nullptr);
+    EXPECT_NE(registry.find_module_constant("parent.child.NESTED"), nullptr);
+    EXPECT_NE(registry.find_module_function("parent.child.func"), nullptr);
+
+    // Functions and constants are not mixed up
+    EXPECT_EQ(registry.find_module_function("parent.CONST"), nullptr);
+    EXPECT_EQ(registry.find_module_constant("parent.child.func"), nullptr);
+
+    // Missing elements, modules and submodules, and names without a module
+    EXPECT_EQ(registry.find_module_constant("parent.MISSING"), nullptr);
+    EXPECT_EQ(registry.find_module_constant("missing.CONST"), nullptr);
+    EXPECT_EQ(registry.find_module_function("parent.missing.func"), nullptr);
+    EXPECT_EQ(registry.find_module_constant("CONST"), nullptr);
+    EXPECT_EQ(registry.find_module_constant("parent"), nullptr);
+}
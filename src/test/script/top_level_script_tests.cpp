@@ -8,10 +8,11 @@
 #include "test/test_data/power_series_parsing_testdata.hpp"
 #include "shell/parameters/parameters.hpp"
 
-void test_single_script(const std::string& filename, const std::vector<std::string>& expected_outputs) {
+void test_single_script(const std::string& filename, const std::vector<std::string>& expected_outputs,
+                        const ShellParameters& parameters = ShellParameters()) {
     auto shell_input = std::make_shared<FileShellInput>(filename);
     auto shell_output = std::make_shared<TestShellOutput>();
-    SymbolicShellEvaluator evaluator(shell_input, shell_output, ShellParameters());
+    SymbolicShellEvaluator evaluator(shell_input, shell_output, parameters);
     evaluator.run();
 
     EXPECT_EQ(expected_outputs.size(), shell_output->printed_outputs.size()) << "Found different output sizes for " << filename;
@@ -20,7 +21,8 @@ void test_single_script(const std::string& filename, const std::vector<std::stri
     }
 }
 
-void test_single_script_wrapper(const std::string& filename, const std::string& expected_results) {
+void test_single_script_wrapper(const std::string& filename, const std::string& expected_results,
+                                const ShellParameters& parameters = ShellParameters()) {
     std::vector<std::string> expected_outputs;
 
     // Read expected outputs from file
@@ -32,7 +34,7 @@ void test_single_script_wrapper(const std::string& filename, const std::string&
     while (std::getline(strm, line)) {
         expected_outputs.push_back(line);
     }
-    test_single_script(filename, expected_outputs);
+    test_single_script(filename, expected_outputs, parameters);
 }
 
 void test_script_interpretation() {
@@ -65,3 +67,22 @@ void test_script_interpretation() {
 TEST(ScriptTests, ScriptInterpretation) {
   test_script_interpretation();
 }
+
+TEST(ScriptTests, ScriptInterpretationWithoutOptimisations) {
+    initialize_command_handler();
+    auto base_folder = "../src/test/script/test_scripts/single_tests";
+
+    // every combination of the optimisations and the execution engine but the default one, where all are enabled
+    for (uint32_t mask = 0; mask < 15; mask++) {
+        auto parameters = ShellParameters();
+        parameters.constant_folding = mask & 1;
+        parameters.hoist_loop_invariants = mask & 2;
+        parameters.inline_functions = mask & 4;
+        parameters.bytecode_execution = mask & 8;
+        for (const auto& entry : std::filesystem::directory_iterator(base_folder)) {
+            if (entry.path().extension() == ".sym") {
+                test_single_script_wrapper(entry.path().string(), entry.path().string()+".results", parameters);
+            }
+        }
+    }
+}
@@ -121,6 +121,19 @@ std::vector<PowerSeriesTestcase> test_cases = {
         // necklaces with 3 colors
         {"combinatorics.symbolic_method.CYC(3*z)", {0, 3, 6, 11, 24, 51, 130, 315, 834, 2195, 5934, 16107, 44368, 122643, 341802, 956635, 2690844, 7596483, 21524542, 61171659, 174342216, 498112275, 1426419858, 4093181691}, false, 0},
 
+        // contiguous cardinality ranges
+        {"combinatorics.symbolic_method.SEQ(2*z, \">=3\")", {0, 0, 0, 8, 16, 32, 64, 128, 256, 512, 1024, 2048}, false, 0},
+        {"combinatorics.symbolic_method.SEQ(z+z^2, \"<=2\")", {1, 1, 2, 2, 1, 0, 0, 0, 0, 0, 0, 0}, false, 0},
+        {"combinatorics.symbolic_method.LSET(z, \">=2\")", {0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, true, 0},
+        {"combinatorics.symbolic_method.LSET(z, \"<4\")", {1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0}, true, 0},
+        {"combinatorics.symbolic_method.LSET(z, \"=0\")", {1, 0, 0, 0, 0, 0, 0, 0, 0, 0}, true, 0},
+        {"combinatorics.symbolic_method.LCYC(z, \"<=3\")", {0, 1, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0}, true, 0},
+        {"combinatorics.symbolic_method.LCYC(z, \">=4\")", {0, 0, 0, 0, 6, 24, 120, 720, 5040, 40320, 362880, 3628800}, true, 0},
+
+        // inverse Euler transform
+        {"combinatorics.symbolic_method.INVMSET(1/(1-z))", {0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, false, 0},
+        {"combinatorics.symbolic_method.INVMSET(combinatorics.symbolic_method.MSET(combinatorics.symbolic_method.SEQ(z, \">0\")))", {0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, false, 0},
+
          // some evals
          {"powerseries.eval(1/(1-z), 2*z)", {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384}, false, 0},
          {"powerseries.eval(1/(1-z), z/(1-z)+powerseries.O(z^60))", {1, 1, 2, 4, 8, 16, 32, 64, 128, 256}, false, 0},
@@ -5,9 +5,12 @@
 
 #include <gtest/gtest.h>
 #include <random>
+#include <sstream>
 #include "types/polynomial.hpp"
 #include "types/rationals.hpp"
 #include "types/bigint.hpp"
+#include "types/modLong.hpp"
+#include "common/kernel_stats.hpp"
 
 TEST(TypeTests, PolyDiv) {
     std::random_device rd;
@@ -41,3 +44,63 @@ TEST(TypeTests, PolyDiv) {
         }
     }
 }
+
+TEST(TypeTests, PolyDivNewton) {
+    std::mt19937 gen(42);
+    const int32_t p = 998244353;
+    std::uniform_int_distribution<int64_t> dist(0, p-1);
+    auto random_polynomial = [&](uint32_t degree) {
+        auto coeffs = std::vector<ModLong>();
+        for (uint32_t ind = 0; ind <= degree; ind++) {
+            coeffs.push_back(ModLong(dist(gen), p));
+        }
+        coeffs.back() = ModLong(1, p);
+        return Polynomial<ModLong>(std::move(coeffs));
+    };
+
+    // degrees of divisor and quotient above NEWTON_DIVISION_THRESHOLD
+    auto b = random_polynomial(NEWTON_DIVISION_THRESHOLD+17);
+    auto q = random_polynomial(NEWTON_DIVISION_THRESHOLD+5);
+    auto r = random_polynomial(NEWTON_DIVISION_THRESHOLD+3);
+    auto [quotient, remainder] = polynomial_div(q*b+r, b);
+    EXPECT_EQ(quotient, q);
+    EXPECT_EQ(remainder, r);
+
+    auto d = random_polynomial(50);
+    auto divisor = PolynomialDivisor<ModLong>(d);
+    for (uint32_t degree : {10, 60, 99, 300}) {
+        auto x = random_polynomial(degree);
+        auto [div_q, div_r] = divisor.divide(x);
+        EXPECT_EQ(div_q, x/d);
+        EXPECT_EQ(div_r, x % d);
+        EXPECT_EQ(divisor.reduce(x), x % d);
+    }
+}
+
+TEST(TypeTests, KernelStatistics) {
+    const int32_t p = 998244353;
+    auto coeffs = std::vector<ModLong>();
+    for (int64_t ind = 0; ind < 200; ind++) {
+        coeffs.push_back(ModLong(ind+1, p));
+    }
+    auto a = Polynomial<ModLong>(std::move(coeffs));
+
+    reset_kernel_statistics();
+    auto product = a*a;
+    EXPECT_EQ(product.degree(), 398);
+
+    // the recursion of Karatsuba multiplication is part of the outermost call
+    auto& counters = kernel_counters[POLYNOMIAL_MULTIPLY];
+    EXPECT_EQ(counters.calls.load(), 1);
+    EXPECT_EQ(counters.timed_calls.load(), 1);
+    EXPECT_EQ(counters.algorithms[KARATSUBA].load(), 1);
+    EXPECT_EQ(counters.max_size.load(), 200);
+    EXPECT_EQ(counters.sizes[8].load(), 1);
+
+    std::stringstream strm;
+    write_kernel_statistics(strm);
+    EXPECT_NE(strm.str().find("polynomial multiplication"), std::string::npos);
+
+    reset_kernel_statistics();
+    EXPECT_EQ(counters.calls.load(), 0);
+}
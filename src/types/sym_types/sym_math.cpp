@@ -1,4 +1,5 @@
 #include <memory>
+#include <limits>
 #include "types/sym_types/sym_math.hpp"
 #include "exceptions/parsing_type_exception.hpp"
 #include "cpp_utils/unused.hpp"
@@ -13,18 +14,37 @@ enum OperationType {
     DIVIDE
 };
 
+/**
+ * @brief Applies the operation; if in_place is set, a is referenced nowhere else and is updated in place whenever the
+ * result has its type. Addition is commutative for all types, so a can also take the result for equal priorities.
+ */
 template<typename T>
-std::shared_ptr<SymMathObject> sym_binary_base(std::shared_ptr<MathWrapperType<T>> a, std::shared_ptr<MathWrapperType<T>> b, const OperationType& op_type) {
+std::shared_ptr<SymMathObject> sym_binary_base(std::shared_ptr<MathWrapperType<T>> a, std::shared_ptr<MathWrapperType<T>> b, const OperationType& op_type,
+                                               const bool in_place) {
     if (!a || !b) {
         throw ParsingTypeException("Type error: Cannot apply binary operation due to type error");
     }
     switch (op_type) {
         case ADD:
-             return a->get_priority() > b->get_priority() ? a->add(b) : b->add(a);
-        case SUBTRACT:
-            b->unary_minus();
+            if (in_place && a->get_priority() >= b->get_priority()) {
+                a->add_in_place(b);
+                return a;
+            }
             return a->get_priority() > b->get_priority() ? a->add(b) : b->add(a);
+        case SUBTRACT: {
+            auto negated = std::dynamic_pointer_cast<MathWrapperType<T>>(b->clone());
+            negated->unary_minus();
+            if (in_place && a->get_priority() >= negated->get_priority()) {
+                a->add_in_place(negated);
+                return a;
+            }
+            return a->get_priority() > negated->get_priority() ? a->add(negated) : negated->add(a);
+        }
         case MULTIPLY:
+            if (in_place && a->get_priority() > b->get_priority()) {
+                a->mult_in_place(b);
+                return a;
+            }
             return a->get_priority() > b->get_priority() ? a->mult(b) : b->mult(a);
         case DIVIDE:
             return a->get_priority() > b->get_priority() ? a->div(b) : b->reverse_div(a);
@@ -33,35 +53,76 @@ std::shared_ptr<SymMathObject> sym_binary_base(std::shared_ptr<MathWrapperType<T
     return nullptr;
 }
 
-std::shared_ptr<SymMathObject> sym_binary(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b, const OperationType& op_type) {
+/**
+ * @brief Applies the operation natively if both operands are integers fitting into a machine word.
+ *
+ * @return The result, or nullptr if an operand is no such integer, the result overflows or a quotient is not an
+ *         integer; then the operation has to be done on rationals of BigInt.
+ */
+std::shared_ptr<SymMathObject> sym_binary_small_integer(const SymMathObject& a, const SymMathObject& b, const OperationType& op_type) {
+    int64_t left, right, result = 0;
+    if (!get_small_integer(a, left) || !get_small_integer(b, right)) {
+        return nullptr;
+    }
+    bool overflow = false;
+    switch (op_type) {
+        case ADD:
+            overflow = __builtin_add_overflow(left, right, &result);
+            break;
+        case SUBTRACT:
+            overflow = __builtin_sub_overflow(left, right, &result);
+            break;
+        case MULTIPLY:
+            overflow = __builtin_mul_overflow(left, right, &result);
+            break;
+        case DIVIDE:
+            // division by zero is reported by the rational arithmetic
+            if (right == 0 || (right == -1 && left == std::numeric_limits<int64_t>::min()) || left % right != 0) {
+                return nullptr;
+            }
+            result = left/right;
+            break;
+    }
+    if (overflow) {
+        return nullptr;
+    }
+    return make_small_integer(result);
+}
+
+std::shared_ptr<SymMathObject> sym_binary(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b, const OperationType& op_type,
+                                          const bool in_place = false) {
+    auto small_result = sym_binary_small_integer(*a, *b, op_type);
+    if (small_result) {
+        return small_result;
+    }
     if (a->get_type() == Datatype::DOUBLE && b->get_type() == Datatype::DOUBLE) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(a);
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(b);
-        return sym_binary_base<double>(a_casted, b_casted, op_type);
+        return sym_binary_base<double>(a_casted, b_casted, op_type, in_place);
     } else if (a->get_type() == Datatype::RATIONAL && b->get_type() == Datatype::RATIONAL) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(a);
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<RationalNumber<BigInt>>>(b);
-        return sym_binary_base<RationalNumber<BigInt>>(a_casted, b_casted, op_type);
+        return sym_binary_base<RationalNumber<BigInt>>(a_casted, b_casted, op_type, in_place);
     } else if (a->get_type() == Datatype::MOD && b->get_type() == Datatype::MOD) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(a);
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(b);
-        return sym_binary_base<ModLong>(a_casted, b_casted, op_type);
+        return sym_binary_base<ModLong>(a_casted, b_casted, op_type, in_place);
     } else if (a->get_type() == Datatype::DOUBLE) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(a);
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(b->as_double());
-        return sym_binary_base<double>(a_casted, b_casted, op_type);
+        return sym_binary_base<double>(a_casted, b_casted, op_type, in_place);
     } else if (b->get_type() == Datatype::DOUBLE) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(a->as_double());
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<double>>(b);
-        return sym_binary_base<double>(a_casted, b_casted, op_type);
+        return sym_binary_base<double>(a_casted, b_casted, op_type, in_place);
     } else if (a->get_type() == Datatype::MOD) {
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(a);
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(b->as_modlong(a_casted->get_coefficient(0).get_modulus()));
-        return sym_binary_base<ModLong>(a_casted, b_casted, op_type);
+        return sym_binary_base<ModLong>(a_casted, b_casted, op_type, in_place);
     } else if (b->get_type() == Datatype::MOD) {
         auto b_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(b);
         auto a_casted = std::dynamic_pointer_cast<MathWrapperType<ModLong>>(a->as_modlong(b_casted->get_coefficient(0).get_modulus()));
-        return sym_binary_base<ModLong>(a_casted, b_casted, op_type);
+        return sym_binary_base<ModLong>(a_casted, b_casted, op_type, in_place);
     }
 
     throw ParsingTypeException("Type error: Cannot apply binary operation due to type error");  // TODO(vabi) add types to error message
@@ -83,3 +144,15 @@ std::shared_ptr<SymMathObject> sym_multiply(std::shared_ptr<SymMathObject> a, st
 std::shared_ptr<SymMathObject> sym_divide(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b) {
     return sym_binary(a, b, OperationType::DIVIDE);
 }
+
+std::shared_ptr<SymMathObject> sym_add_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b) {
+    return sym_binary(a, b, OperationType::ADD, true);
+}
+
+std::shared_ptr<SymMathObject> sym_subtract_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b) {
+    return sym_binary(a, b, OperationType::SUBTRACT, true);
+}
+
+std::shared_ptr<SymMathObject> sym_multiply_in_place(std::shared_ptr<SymMathObject> a, std::shared_ptr<SymMathObject> b) {
+    return sym_binary(a, b, OperationType::MULTIPLY, true);
+}